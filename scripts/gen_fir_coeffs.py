@@ -0,0 +1,195 @@
+#!/usr/bin/env python3
+"""
+Generate the windowed-sinc FIR coefficient tables of src/filter.c.
+
+The design is the same Blackman-windowed sinc filter.c falls back to at boot,
+evaluated in double precision: one bandpass kernel, or with --cascade a
+high-pass and a low-pass stage. The cutoffs are read from src/filter.h, the
+tap count follows the MAC budget rule of src/filter.c for the given output
+rate and channel count. filter.c only uses the tables when the output rate,
+order and stages they were designed for match its own, otherwise it designs
+the taps at boot.
+
+Every run also checks that the bandpass response stays within
+CASCADE_TOLERANCE of the cascade it replaces, and fails the build otherwise.
+"""
+
+import argparse
+import math
+import re
+import sys
+from pathlib import Path
+
+# ADS1299 data rates, CONFIG_TI_ADS1299_DATA_RATE_SPS
+DATA_RATES = (250, 500, 1000, 2000, 4000, 8000, 16000)
+# Largest decimation in front of the filters, see src/decimate.c
+MAX_DECIMATION = 16
+
+# Keep in sync with FILTER_MAC_BUDGET and the order cap in src/filter.c
+MAC_BUDGET = 3200000
+MAX_ORDER = 401
+
+# Largest |H| difference allowed between the bandpass and the cascade
+CASCADE_TOLERANCE = 0.01
+# Frequencies the responses are compared at, from DC to Nyquist
+CHECK_POINTS = 2048
+# Blackman window transition width in cycles/sample, times the tap count
+BLACKMAN_TRANSITION = 5.5
+
+
+def filter_order(rate, channels):
+    return min(MAX_ORDER, MAC_BUDGET // (2 * channels * rate) - 1)
+
+
+def read_cutoffs(filter_h):
+    text = Path(filter_h).read_text()
+    cutoffs = {}
+
+    for edge in ("HIGHPASS", "LOWPASS"):
+        m = re.search(rf"#define\s+FILTER_{edge}_CUTOFF\s+([0-9.]+)f?", text)
+        if m is None:
+            sys.exit(f"{filter_h}: FILTER_{edge}_CUTOFF not found")
+        cutoffs[edge] = float(m.group(1))
+
+    return cutoffs["HIGHPASS"], cutoffs["LOWPASS"]
+
+
+def lowpass(order, cutoff, rate):
+    fc = cutoff / rate
+    coeffs = []
+
+    for n in range(order + 1):
+        # Centre tap as filter.c picks it, order / 2 in integer arithmetic
+        if n == order // 2:
+            h = 2.0 * fc
+        else:
+            nm = n - order / 2.0
+            h = math.sin(2.0 * math.pi * fc * nm) / (math.pi * nm)
+        h *= (0.42 - 0.5 * math.cos(2.0 * math.pi * n / order) +
+              0.08 * math.cos(4.0 * math.pi * n / order))
+        coeffs.append(h)
+
+    total = sum(coeffs)
+    return [h / total for h in coeffs]
+
+
+def highpass(order, cutoff, rate):
+    # Spectral inversion of a unity-gain lowpass: delta - lowpass
+    coeffs = [-h for h in lowpass(order, cutoff, rate)]
+    coeffs[order // 2] += 1.0
+    return coeffs
+
+
+def bandpass(order, low_cutoff, high_cutoff, rate):
+    # Difference of two unity-gain lowpasses
+    return [h - l for h, l in zip(lowpass(order, high_cutoff, rate),
+                                  lowpass(order, low_cutoff, rate))]
+
+
+def magnitude(coeffs, w):
+    re = sum(h * math.cos(w * k) for k, h in enumerate(coeffs))
+    im = sum(h * math.sin(w * k) for k, h in enumerate(coeffs))
+    return math.hypot(re, im)
+
+
+def check_cascade(order, low_cutoff, high_cutoff, rate):
+    """Largest |H| difference between the bandpass and the cascade."""
+    bp = bandpass(order, low_cutoff, high_cutoff, rate)
+    hp = highpass(order, low_cutoff, rate)
+    lp = lowpass(order, high_cutoff, rate)
+    worst = (0.0, 0.0)
+
+    for i in range(CHECK_POINTS + 1):
+        w = math.pi * i / CHECK_POINTS
+        diff = abs(magnitude(bp, w) - magnitude(hp, w) * magnitude(lp, w))
+        worst = max(worst, (diff, w * rate / (2.0 * math.pi)))
+
+    return worst
+
+
+def to_q31(h):
+    return max(-(1 << 31), min((1 << 31) - 1, round(h * (1 << 31))))
+
+
+def table(ctype, name, stages, fmt):
+    lines = [f"static const {ctype} {name}"
+             f"[{len(stages)}][{len(stages[0])}] = {{"]
+    for values in stages:
+        lines.append("\t{")
+        for i in range(0, len(values), 4):
+            lines.append("\t\t" +
+                         " ".join(fmt(v) + "," for v in values[i:i + 4]))
+        lines.append("\t},")
+    lines.append("};")
+    return lines
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__)
+    parser.add_argument("--filter-h", required=True,
+                        help="src/filter.h to read the cutoffs from")
+    parser.add_argument("--rate", type=int, required=True,
+                        help="output rate in SPS, after decimation")
+    parser.add_argument("--channels", type=int, required=True,
+                        help="EEG channels across the daisy chain")
+    parser.add_argument("--cascade", action="store_true",
+                        help="separate high-pass and low-pass stages "
+                        "(CONFIG_APP_EEG_FIR_CASCADE)")
+    parser.add_argument("output", help="header to write")
+    args = parser.parse_args()
+
+    if not any(r % args.rate == 0 and r // args.rate <= MAX_DECIMATION
+               for r in DATA_RATES):
+        sys.exit(f"unsupported output rate {args.rate}")
+
+    hp_cutoff, lp_cutoff = read_cutoffs(args.filter_h)
+    order = filter_order(args.rate, args.channels)
+
+    # At high data rates the MAC budget leaves too few taps for either
+    # design to have a passband, there is nothing to compare. Only the
+    # filter bench builds such tables, src/filter.c rejects them for the
+    # FIR profile.
+    transition = BLACKMAN_TRANSITION * args.rate / (order + 1)
+    if transition < lp_cutoff - hp_cutoff:
+        diff, freq = check_cascade(order, hp_cutoff, lp_cutoff, args.rate)
+        if diff > CASCADE_TOLERANCE:
+            sys.exit(f"bandpass differs from the cascade by {diff:.4f} at "
+                     f"{freq:.2f} Hz, more than {CASCADE_TOLERANCE}")
+    else:
+        print(f"gen_fir_coeffs: {order + 1} taps at {args.rate} SPS cannot "
+              f"resolve {hp_cutoff:g}-{lp_cutoff:g} Hz, cascade check skipped",
+              file=sys.stderr)
+
+    if args.cascade:
+        stages = [highpass(order, hp_cutoff, args.rate),
+                  lowpass(order, lp_cutoff, args.rate)]
+    else:
+        stages = [bandpass(order, hp_cutoff, lp_cutoff, args.rate)]
+
+    f32 = lambda v: f"{v:.9e}f"
+    q31 = lambda v: f"{to_q31(v)}"
+
+    out = [
+        "/* Generated by scripts/gen_fir_coeffs.py, do not edit */",
+        "",
+        f"/* {hp_cutoff:g} Hz high-pass and {lp_cutoff:g} Hz low-pass, "
+        f"{args.rate} SPS, order {order} */",
+        f"#if FILTER_SAMPLING_RATE == {args.rate} && "
+        f"FILTER_ORDER == {order} && FIR_STAGES == {len(stages)}",
+        "#define FIR_COEFFS_GENERATED 1",
+        "",
+        *table("float32_t", "fir_coeffs", stages, f32),
+        "",
+        "#ifdef FILTER_Q31",
+        *table("q31_t", "fir_coeffs_q31", stages, q31),
+        "#endif",
+        "#endif",
+        "",
+    ]
+
+    Path(args.output).parent.mkdir(parents=True, exist_ok=True)
+    Path(args.output).write_text("\n".join(out))
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,164 @@
+#include "bandpower.h"
+
+#include <errno.h>
+#include <math.h>
+#include <string.h>
+
+#ifdef CONFIG_APP_EEG_FEATURES
+
+#define SEG_LEN FEATURES_SEGMENT_LEN
+BUILD_ASSERT(IS_POWER_OF_TWO(SEG_LEN) && SEG_LEN >= 32 && SEG_LEN <= 4096,
+	     "arm_rfft_fast_f32 takes powers of two from 32 to 4096");
+
+/* Generalized cosine window: a0 - a1 cos(2 pi n / N) + a2 cos(4 pi n / N) */
+#if defined(CONFIG_APP_FEATURES_WINDOW_HAMMING)
+#define WINDOW_A0 0.54
+#define WINDOW_A1 0.46
+#define WINDOW_A2 0.0
+#elif defined(CONFIG_APP_FEATURES_WINDOW_BLACKMAN)
+#define WINDOW_A0 0.42
+#define WINDOW_A1 0.5
+#define WINDOW_A2 0.08
+#else
+#define WINDOW_A0 0.5
+#define WINDOW_A1 0.5
+#define WINDOW_A2 0.0
+#endif
+
+/*
+ * Band edges in Hz, the lower one inclusive. Below FILTER_HIGHPASS_CUTOFF and
+ * above FILTER_LOWPASS_CUTOFF the filter chain has already attenuated delta
+ * and gamma.
+ */
+static const float32_t band_edges[EEG_BAND_COUNT][2] = {
+	[EEG_BAND_DELTA] = { 1.0f, 4.0f },
+	[EEG_BAND_THETA] = { 4.0f, 8.0f },
+	[EEG_BAND_ALPHA] = { 8.0f, 13.0f },
+	[EEG_BAND_BETA] = { 13.0f, 30.0f },
+	[EEG_BAND_GAMMA] = { 30.0f, 45.0f },
+};
+// 대역별 FFT 빈 범위 [lo, hi), DC와 나이퀴스트 빈은 제외
+static uint16_t band_bins[EEG_BAND_COUNT][2];
+
+static arm_rfft_fast_instance_f32 rfft;
+static float32_t window[SEG_LEN];
+// 단측 |X[k]|^2를 빈 하나의 전력(V^2)으로: 2 / (N * sum(w^2))
+static float32_t power_scale;
+
+// 채널별 최근 SEG_LEN개 샘플(V), pos가 가장 오래된 샘플
+static float32_t history[EEG_MAX_CHANNELS][SEG_LEN];
+static uint16_t pos;
+static int channels;
+
+// 채널별 최근 FEATURES_SEGMENTS개 세그먼트의 대역 전력
+static float32_t segment_power[EEG_MAX_CHANNELS][FEATURES_SEGMENTS]
+			      [EEG_BAND_COUNT];
+static uint8_t segment;
+static uint8_t segments;
+
+static float32_t fft_in[SEG_LEN];
+static float32_t fft_out[SEG_LEN];
+static float32_t spectrum[SEG_LEN / 2];
+
+int bandpower_init(void)
+{
+	double sum_sq = 0.0;
+
+	if (arm_rfft_fast_init_f32(&rfft, SEG_LEN) != ARM_MATH_SUCCESS) {
+		return -EINVAL;
+	}
+
+	for (int n = 0; n < SEG_LEN; n++) {
+		double w = WINDOW_A0 - WINDOW_A1 * cos(2.0 * PI * n / SEG_LEN) +
+			   WINDOW_A2 * cos(4.0 * PI * n / SEG_LEN);
+
+		window[n] = w;
+		sum_sq += w * w;
+	}
+	power_scale = 2.0 / (SEG_LEN * sum_sq);
+
+	for (int b = 0; b < EEG_BAND_COUNT; b++) {
+		for (int edge = 0; edge < 2; edge++) {
+			float32_t bin = ceilf(band_edges[b][edge] * SEG_LEN /
+					      EEG_OUTPUT_RATE);
+
+			band_bins[b][edge] = CLAMP(bin, 1, SEG_LEN / 2);
+		}
+	}
+
+	return 0;
+}
+
+void bandpower_reset(int num_channels)
+{
+	channels = num_channels;
+	pos = 0;
+	segment = 0;
+	segments = 0;
+	memset(history, 0, sizeof(history[0]) * num_channels);
+	memset(segment_power, 0, sizeof(segment_power[0]) * num_channels);
+}
+
+void bandpower_push(const struct eeg_block *block, size_t first, size_t count)
+{
+	for (size_t i = first; i < first + count; i++) {
+		for (int ch = 0; ch < channels; ch++) {
+			history[ch][pos] =
+				eeg_sample_to_volts(block->samples[ch][i]);
+		}
+		pos = (pos + 1 == SEG_LEN) ? 0 : pos + 1;
+	}
+}
+
+// 세그먼트 하나의 대역 전력
+static void segment_update(int ch, float32_t *power)
+{
+	const size_t tail = SEG_LEN - pos;
+
+	// 가장 오래된 샘플부터 창 함수를 곱해 펼침
+	arm_mult_f32(&history[ch][pos], window, fft_in, tail);
+	arm_mult_f32(history[ch], &window[tail], &fft_in[tail], pos);
+	arm_rfft_fast_f32(&rfft, fft_in, fft_out, 0);
+	// fft_out[0], [1]은 DC와 나이퀴스트의 실수부, 빈 1부터 계산
+	arm_cmplx_mag_squared_f32(&fft_out[2], &spectrum[1], SEG_LEN / 2 - 1);
+
+	for (int b = 0; b < EEG_BAND_COUNT; b++) {
+		float32_t sum = 0.0f;
+
+		for (int k = band_bins[b][0]; k < band_bins[b][1]; k++) {
+			sum += spectrum[k];
+		}
+		power[b] = sum * power_scale;
+	}
+}
+
+void bandpower_update(struct eeg_features *features)
+{
+	for (int ch = 0; ch < channels; ch++) {
+		segment_update(ch, segment_power[ch][segment]);
+	}
+	segment = (segment + 1) % FEATURES_SEGMENTS;
+	segments = MIN(segments + 1, FEATURES_SEGMENTS);
+
+	// Welch 평균, 아직 채워지지 않은 세그먼트는 0
+	for (int ch = 0; ch < channels; ch++) {
+		float32_t *power = features->band_power[ch];
+		float32_t total = 0.0f;
+
+		for (int b = 0; b < EEG_BAND_COUNT; b++) {
+			float32_t sum = 0.0f;
+
+			for (int s = 0; s < FEATURES_SEGMENTS; s++) {
+				sum += segment_power[ch][s][b];
+			}
+			power[b] = sum / segments;
+			total += power[b];
+		}
+		for (int b = 0; b < EEG_BAND_COUNT; b++) {
+			features->relative_power[ch][b] =
+				total > 0.0f ? power[b] / total : 0.0f;
+		}
+	}
+	features->num_channels = channels;
+}
+#endif
@@ -0,0 +1,26 @@
+#ifndef __APP_BANDPOWER_H__
+#define __APP_BANDPOWER_H__
+
+#include "eeg.h"
+#include "eeg_features.h"
+
+#include <stddef.h>
+
+/** @brief Design the window and the FFT, before the first bandpower_reset(). */
+int bandpower_init(void);
+
+/** @brief Drop the buffered samples and segments of num_channels channels. */
+void bandpower_reset(int num_channels);
+
+/** @brief Append frames first to first + count - 1 of every channel. */
+void bandpower_push(const struct eeg_block *block, size_t first, size_t count);
+
+/**
+ * @brief Analyse the newest FEATURES_SEGMENT_LEN samples as one segment and
+ * write the average over the last FEATURES_SEGMENTS segments.
+ *
+ * Call once per FEATURES_HOP pushed samples, once the first segment is full.
+ */
+void bandpower_update(struct eeg_features *features);
+
+#endif // __APP_BANDPOWER_H__
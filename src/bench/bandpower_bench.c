@@ -0,0 +1,80 @@
+/*
+ * Boot-time check of the Welch band powers against a known signal: a sine
+ * in the middle of the alpha band must show up with its full power in the
+ * alpha band and nowhere else. Segments coarser than about 2 Hz per bin
+ * leak it into the neighbouring bands and fail the check.
+ */
+#include "bench.h"
+#include "../bandpower.h"
+#include "../eeg.h"
+#include "../eeg_features.h"
+
+#include <math.h>
+#include <zephyr/init.h>
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+
+LOG_MODULE_REGISTER(bandpower_bench, CONFIG_APP_LOG_LEVEL);
+
+// 알파 대역 (8-13 Hz) 가운데의 20 uV 사인
+#define BENCH_FREQ 10.5f
+#define BENCH_AMPLITUDE 20e-6f
+
+static struct eeg_block bench_block;
+static struct eeg_features bench_features;
+
+// 사인의 샘플 n부터 count개를 블록 단위로 넣음
+static void bench_push(uint32_t n, uint32_t count)
+{
+	while (count > 0) {
+		uint32_t m = MIN(count, EEG_BLOCK_FRAMES);
+
+		for (uint32_t i = 0; i < m; i++) {
+			bench_block.samples[0][i] = bench_sample(
+				BENCH_AMPLITUDE *
+				sinf(2.0f * PI * BENCH_FREQ * (n + i) /
+				     EEG_OUTPUT_RATE));
+		}
+		bandpower_push(&bench_block, 0, m);
+		n += m;
+		count -= m;
+	}
+}
+
+static int bandpower_bench(void)
+{
+	const float32_t power = BENCH_AMPLITUDE * BENCH_AMPLITUDE / 2.0f;
+	const float32_t *relative = bench_features.relative_power[0];
+	uint32_t n = FEATURES_SEGMENT_LEN;
+	int err = bandpower_init();
+
+	if (err) {
+		LOG_ERR("Error initializing band powers, err: %d", err);
+		return 0;
+	}
+	bandpower_reset(1);
+	bench_block.num_channels = 1;
+
+	// Welch 평균이 채워질 때까지 세그먼트마다 갱신
+	bench_push(0, n);
+	bandpower_update(&bench_features);
+	for (int s = 1; s < FEATURES_SEGMENTS; s++) {
+		bench_push(n, FEATURES_HOP);
+		n += FEATURES_HOP;
+		bandpower_update(&bench_features);
+	}
+
+	bench_check("alpha power (uV^2)",
+		    bench_features.band_power[0][EEG_BAND_ALPHA] * 1e12f,
+		    power * 1e12f, 0.05f * power * 1e12f);
+	bench_check("alpha relative power", relative[EEG_BAND_ALPHA], 1.0f,
+		    0.05f);
+	bench_check("theta relative power", relative[EEG_BAND_THETA], 0.0f,
+		    0.05f);
+	bench_check("beta relative power", relative[EEG_BAND_BETA], 0.0f,
+		    0.05f);
+
+	return 0;
+}
+
+SYS_INIT(bandpower_bench, APPLICATION, BENCH_INIT_PRIORITY);
@@ -0,0 +1,19 @@
+#include "bench.h"
+
+#include <math.h>
+#include <zephyr/logging/log.h>
+
+LOG_MODULE_REGISTER(bench, CONFIG_APP_LOG_LEVEL);
+
+bool bench_check(const char *what, float32_t value, float32_t expected,
+		 float32_t tolerance)
+{
+	if (fabsf(value - expected) > tolerance) {
+		LOG_ERR("%s: %g, expected %g", what, (double)value,
+			(double)expected);
+		return false;
+	}
+	LOG_INF("%s: %g", what, (double)value);
+
+	return true;
+}
@@ -0,0 +1,63 @@
+#ifndef __APP_BENCH_H__
+#define __APP_BENCH_H__
+
+#include "../eeg.h"
+
+#include <arm_math.h>
+#include <math.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <zephyr/kernel.h>
+
+/*
+ * Shared harness of the on-device benchmarks. There is no host test runner
+ * for the application, so each APP_*_BENCH option links one file of this
+ * directory that runs once from SYS_INIT, after the filter coefficients and
+ * pools are set up and before the EEG threads start. Timed sections run with
+ * interrupts locked; checks against known signals log an error on mismatch.
+ * The benches leave the state they touch to be reset by the EEG thread.
+ */
+#define BENCH_INIT_PRIORITY 99
+
+struct bench_timer {
+	unsigned int key;
+	uint32_t start;
+};
+
+/** @brief Lock interrupts and start counting cycles. */
+static inline void bench_start(struct bench_timer *timer)
+{
+	timer->key = irq_lock();
+	timer->start = k_cycle_get_32();
+}
+
+/** @brief Cycles since bench_start(), with interrupts unlocked again. */
+static inline uint32_t bench_stop(struct bench_timer *timer)
+{
+	uint32_t cycles = k_cycle_get_32() - timer->start;
+
+	irq_unlock(timer->key);
+
+	return cycles;
+}
+
+/** @brief Sample of @p volts, the inverse of eeg_sample_to_volts(). */
+static inline eeg_sample_t bench_sample(float32_t volts)
+{
+#ifdef CONFIG_APP_EEG_Q31
+	return (q31_t)lrintf(volts / (EEG_LSB_VOLTS / (1 << EEG_Q31_SHIFT)));
+#else
+	return volts;
+#endif
+}
+
+/**
+ * @brief Log a measured value against the expected one.
+ *
+ * @return true if value is within tolerance of expected, otherwise false
+ * after logging an error.
+ */
+bool bench_check(const char *what, float32_t value, float32_t expected,
+		 float32_t tolerance);
+
+#endif // __APP_BENCH_H__
@@ -0,0 +1,60 @@
+/*
+ * Boot-time measurement of the filter chain's cost per sample against the
+ * processing block size.
+ */
+#include "bench.h"
+#include "../eeg.h"
+#include "../filter.h"
+
+#include <zephyr/init.h>
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+
+LOG_MODULE_REGISTER(block_bench, CONFIG_APP_LOG_LEVEL);
+
+// 블록 크기마다 채널당 처리할 샘플 수 (EEG_BLOCK_MAX의 배수)
+#define BENCH_SAMPLES 256
+
+static struct eeg_block bench_in = { .num_channels = EEG_MAX_CHANNELS };
+static struct eeg_block bench_out;
+
+static uint32_t bench_block(uint32_t block)
+{
+	struct bench_timer timer;
+
+	bench_start(&timer);
+	for (uint32_t done = 0; done < BENCH_SAMPLES; done += block) {
+		bench_in.count = MIN(block, BENCH_SAMPLES - done);
+		filteringEEGBlock(&bench_in, &bench_out);
+	}
+
+	return bench_stop(&timer);
+}
+
+static void bench_report(uint32_t block)
+{
+	uint32_t cycles = bench_block(block);
+
+	LOG_INF("block %2u: %u cycles/sample", block,
+		cycles / (BENCH_SAMPLES * EEG_MAX_CHANNELS));
+}
+
+static int block_bench(void)
+{
+	for (int ch = 0; ch < EEG_MAX_CHANNELS; ch++) {
+		for (uint32_t i = 0; i < EEG_BLOCK_FRAMES; i++) {
+			bench_in.samples[ch][i] = eeg_decode_sample(
+				(const uint8_t[]){ 0x00, i, 0x00 });
+		}
+	}
+
+	// 1, 2, 4, ... 그리고 설정된 블록 크기
+	for (uint32_t block = 1; block < EEG_BLOCK_FRAMES; block <<= 1) {
+		bench_report(block);
+	}
+	bench_report(EEG_BLOCK_FRAMES);
+
+	return 0;
+}
+
+SYS_INIT(block_bench, APPLICATION, BENCH_INIT_PRIORITY);
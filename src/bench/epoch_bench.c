@@ -0,0 +1,88 @@
+/*
+ * Boot-time check of the epoch features against a known signal: one epoch
+ * of a sine, read back through the sample bus like any other consumer,
+ * against the closed-form Hjorth parameters, RMS, line length and
+ * zero-crossing rate of a sampled sine.
+ */
+#include "bench.h"
+#include "../eeg.h"
+#include "../epoch.h"
+#include "../sample_bus.h"
+
+#include <math.h>
+#include <zephyr/init.h>
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+
+LOG_MODULE_REGISTER(epoch_bench, CONFIG_APP_LOG_LEVEL);
+
+// 10 Hz, 20 uV 사인, 0을 정확히 지나는 샘플이 없도록 위상을 둠
+#define BENCH_FREQ 10.0f
+#define BENCH_AMPLITUDE 20e-6f
+#define BENCH_PHASE 0.3f
+
+SAMPLE_SUB_DEFINE(epoch_bench_sub, BIT(SAMPLE_TOPIC_EPOCH), 1,
+		  SAMPLE_DROP_OLDEST);
+
+static struct eeg_block bench_block;
+
+static void bench_check_epoch(const struct eeg_epoch_channel *c)
+{
+	const float32_t w = 2.0f * PI * BENCH_FREQ / EEG_OUTPUT_RATE;
+	const float32_t a2 = BENCH_AMPLITUDE * BENCH_AMPLITUDE;
+	// 표본화된 사인의 차분은 진폭 2 sin(w / 2)인 같은 주파수의 사인
+	const float32_t mobility = 2.0f * sinf(w / 2.0f);
+	const float32_t crossings = 2.0f * BENCH_FREQ;
+
+	bench_check("activity (uV^2)", c->activity * 1e12f, a2 / 2.0f * 1e12f,
+		    0.02f * a2 / 2.0f * 1e12f);
+	bench_check("mobility", c->mobility, mobility, 0.02f * mobility);
+	bench_check("complexity", c->complexity, 1.0f, 0.05f);
+	bench_check("rms (uV)", c->rms * 1e6f,
+		    BENCH_AMPLITUDE / sqrtf(2.0f) * 1e6f,
+		    0.01f * BENCH_AMPLITUDE * 1e6f);
+	// 평균 |차분|은 (2 / pi) * 2 sin(w / 2) A
+	bench_check("line length (uV)", c->line_length * 1e6f,
+		    2.0f / PI * mobility * BENCH_AMPLITUDE * EPOCH_LEN * 1e6f,
+		    0.03f * 2.0f / PI * mobility * BENCH_AMPLITUDE *
+			    EPOCH_LEN * 1e6f);
+	// 에포크 경계에서 한 번의 교차가 어긋날 수 있음
+	bench_check("zero-crossing rate (/s)", c->zero_crossing_rate,
+		    crossings, 1.0f * EEG_OUTPUT_RATE / EPOCH_LEN);
+}
+
+static int epoch_bench(void)
+{
+	struct sample_msg msg;
+	uint32_t n = 0;
+
+	sample_bus_subscribe(&epoch_bench_sub);
+	epoch_reset(1);
+	bench_block.num_channels = 1;
+
+	while (n < EPOCH_LEN) {
+		bench_block.count = MIN(EPOCH_LEN - n, EEG_BLOCK_FRAMES);
+		bench_block.seq = n;
+		for (uint32_t i = 0; i < bench_block.count; i++, n++) {
+			bench_block.samples[0][i] = bench_sample(
+				BENCH_AMPLITUDE *
+				sinf(2.0f * PI * BENCH_FREQ * n /
+					     EEG_OUTPUT_RATE +
+				     BENCH_PHASE));
+		}
+		epoch_push(&bench_block);
+	}
+
+	if (sample_sub_get(&epoch_bench_sub, &msg, K_NO_WAIT) != 0) {
+		LOG_ERR("No epoch published after %d samples", EPOCH_LEN);
+	} else {
+		bench_check_epoch(&CONTAINER_OF(msg.obj, struct eeg_epoch, ref)
+					   ->channel[0]);
+		sample_ref_put(msg.obj);
+	}
+	sample_bus_unsubscribe(&epoch_bench_sub);
+
+	return 0;
+}
+
+SYS_INIT(epoch_bench, APPLICATION, BENCH_INIT_PRIORITY);
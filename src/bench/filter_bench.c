@@ -0,0 +1,73 @@
+/*
+ * Boot-time comparison of the filter engines: cycles per sample over the
+ * configured block size and magnitude response at a few frequencies.
+ */
+#include "bench.h"
+#include "../eeg.h"
+#include "../filter.h"
+
+#include <math.h>
+#include <zephyr/init.h>
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+
+LOG_MODULE_REGISTER(filter_bench, CONFIG_APP_LOG_LEVEL);
+
+// 엔진마다 채널당 처리할 샘플 수
+#define BENCH_SAMPLES 256
+
+static const struct filter_engine *const engines[] = {
+	&filter_fir,
+	&filter_iir,
+};
+
+// 통과 대역 가장자리와 전원 주파수 주변
+static const float32_t bench_freqs[] = { 0.5f, 1.0f, 2.0f, 5.0f,  10.0f,
+					 20.0f, 40.0f, 50.0f, 60.0f, 100.0f };
+
+static float32_t bench_in[EEG_MAX_CHANNELS][EEG_BLOCK_FRAMES];
+static float32_t bench_out[EEG_MAX_CHANNELS][EEG_BLOCK_FRAMES];
+
+static uint32_t bench_engine(const struct filter_engine *engine)
+{
+	struct bench_timer timer;
+	uint32_t cycles;
+
+	engine->init();
+	engine->reset(EEG_MAX_CHANNELS);
+
+	bench_start(&timer);
+	for (uint32_t done = 0; done < BENCH_SAMPLES;
+	     done += EEG_BLOCK_FRAMES) {
+		engine->process(bench_in, bench_out,
+				MIN(EEG_BLOCK_FRAMES, BENCH_SAMPLES - done));
+	}
+	cycles = bench_stop(&timer);
+
+	return cycles / (BENCH_SAMPLES * EEG_MAX_CHANNELS);
+}
+
+static int filter_bench(void)
+{
+	for (int ch = 0; ch < EEG_MAX_CHANNELS; ch++) {
+		for (uint32_t i = 0; i < EEG_BLOCK_FRAMES; i++) {
+			bench_in[ch][i] = (float32_t)i * 1e-6f;
+		}
+	}
+
+	for (size_t e = 0; e < ARRAY_SIZE(engines); e++) {
+		LOG_INF("%s: %u cycles/sample, block %d", engines[e]->name,
+			bench_engine(engines[e]), EEG_BLOCK_FRAMES);
+	}
+
+	for (size_t f = 0; f < ARRAY_SIZE(bench_freqs); f++) {
+		LOG_INF("%6.1f Hz: fir %7.2f dB, iir %7.2f dB",
+			(double)bench_freqs[f],
+			20.0 * log10(filter_fir.magnitude(bench_freqs[f])),
+			20.0 * log10(filter_iir.magnitude(bench_freqs[f])));
+	}
+
+	return 0;
+}
+
+SYS_INIT(filter_bench, APPLICATION, BENCH_INIT_PRIORITY);
@@ -0,0 +1,103 @@
+/*
+ * Boot-time comparison of the float and q31 signal paths of the selected
+ * filter engine: cycles per sample from ADC code to filter output, and the
+ * largest difference between the two outputs in ADC LSBs.
+ */
+#include "bench.h"
+#include "../eeg.h"
+#include "../filter.h"
+
+#include <math.h>
+#include <zephyr/init.h>
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+
+LOG_MODULE_REGISTER(q31_bench, CONFIG_APP_LOG_LEVEL);
+
+// 채널당 처리할 샘플 수 (필터 과도 응답이 충분히 지나도록)
+#define BENCH_SAMPLES 2048
+
+// 10 mV 전극 오프셋 + 100 uV 10 Hz 알파파 + 20 uV 50 Hz 전원 잡음 (ADC 코드)
+#define BENCH_OFFSET_CODES (0.010f / EEG_LSB_VOLTS)
+#define BENCH_ALPHA_CODES (100e-6f / EEG_LSB_VOLTS)
+#define BENCH_MAINS_CODES (20e-6f / EEG_LSB_VOLTS)
+
+static int32_t codes[EEG_MAX_CHANNELS][EEG_BLOCK_FRAMES];
+static float32_t in_f32[EEG_MAX_CHANNELS][EEG_BLOCK_FRAMES];
+static float32_t out_f32[EEG_MAX_CHANNELS][EEG_BLOCK_FRAMES];
+static q31_t in_q31[EEG_MAX_CHANNELS][EEG_BLOCK_FRAMES];
+static q31_t out_q31[EEG_MAX_CHANNELS][EEG_BLOCK_FRAMES];
+
+static void bench_codes(uint32_t first, uint32_t count)
+{
+	for (int ch = 0; ch < EEG_MAX_CHANNELS; ch++) {
+		for (uint32_t i = 0; i < count; i++) {
+			float32_t t = (float32_t)(first + i) /
+				      FILTER_SAMPLING_RATE;
+
+			codes[ch][i] = (int32_t)(
+				BENCH_OFFSET_CODES +
+				BENCH_ALPHA_CODES *
+					arm_sin_f32(2.0f * PI * 10.0f * t) +
+				BENCH_MAINS_CODES *
+					arm_sin_f32(2.0f * PI * 50.0f * t));
+		}
+	}
+}
+
+static int q31_bench(void)
+{
+	const struct filter_engine *engine = filterEngine();
+	uint32_t cyc_f32 = 0, cyc_q31 = 0, start;
+	float32_t max_err = 0.0f;
+	struct bench_timer timer;
+
+	engine->reset(EEG_MAX_CHANNELS);
+
+	// 구간별 사이클은 따로 재고 잠금만 전체에 걸쳐 유지
+	bench_start(&timer);
+	for (uint32_t done = 0; done < BENCH_SAMPLES;
+	     done += EEG_BLOCK_FRAMES) {
+		uint32_t n = MIN(EEG_BLOCK_FRAMES, BENCH_SAMPLES - done);
+
+		bench_codes(done, n);
+
+		start = k_cycle_get_32();
+		for (int ch = 0; ch < EEG_MAX_CHANNELS; ch++) {
+			for (uint32_t i = 0; i < n; i++) {
+				in_f32[ch][i] = codes[ch][i] * EEG_LSB_VOLTS;
+			}
+		}
+		engine->process(in_f32, out_f32, n);
+		cyc_f32 += k_cycle_get_32() - start;
+
+		start = k_cycle_get_32();
+		for (int ch = 0; ch < EEG_MAX_CHANNELS; ch++) {
+			for (uint32_t i = 0; i < n; i++) {
+				in_q31[ch][i] = eeg_code_to_q31(codes[ch][i]);
+			}
+		}
+		engine->process_q31(in_q31, out_q31, n);
+		cyc_q31 += k_cycle_get_32() - start;
+
+		for (int ch = 0; ch < EEG_MAX_CHANNELS; ch++) {
+			for (uint32_t i = 0; i < n; i++) {
+				float32_t err = eeg_q31_to_volts(out_q31[ch][i]) -
+						out_f32[ch][i];
+
+				max_err = MAX(max_err, fabsf(err));
+			}
+		}
+	}
+	bench_stop(&timer);
+
+	LOG_INF("%s: f32 %u cycles/sample, q31 %u cycles/sample, "
+		"max difference %.2f LSB",
+		engine->name, cyc_f32 / (BENCH_SAMPLES * EEG_MAX_CHANNELS),
+		cyc_q31 / (BENCH_SAMPLES * EEG_MAX_CHANNELS),
+		(double)(max_err / EEG_LSB_VOLTS));
+
+	return 0;
+}
+
+SYS_INIT(q31_bench, APPLICATION, BENCH_INIT_PRIORITY);
@@ -0,0 +1,130 @@
+/*
+ * Boot-time check of the signal quality index against known signals, two
+ * windows after a reset so the first, settling one is skipped. The raw
+ * frames go through quality_push_raw() as process_block() hands them over:
+ * - channel 0: EEG with mains at twice its amplitude before the filters,
+ *   which must read as four times the EEG power on the line ratio;
+ * - channel 1: clean EEG on raw codes stuck near the positive rail.
+ */
+#include "bench.h"
+#include "../eeg.h"
+#include "../frame_pool.h"
+#include "../quality.h"
+#include "../sample_bus.h"
+
+#include <math.h>
+#include <string.h>
+#include <zephyr/init.h>
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+
+LOG_MODULE_REGISTER(quality_bench, CONFIG_APP_LOG_LEVEL);
+
+// 10 Hz, 20 uV EEG와 두 배 진폭의 전원 잡음
+#define BENCH_FREQ 10.0f
+#define BENCH_AMPLITUDE 20e-6f
+#define BENCH_MAINS_AMPLITUDE (2.0f * BENCH_AMPLITUDE)
+// QUALITY_RAIL_CODE (약 95 %)보다 크고 포화보다 작은 코드
+#define BENCH_RAIL_CODE 0x7c0000
+
+// 블록마다 출력 샘플 수와 그 샘플을 낸 원시 프레임 수
+#define BENCH_OUTPUTS MAX(1, EEG_BLOCK_FRAMES / EEG_DECIMATION)
+#define BENCH_FRAMES (BENCH_OUTPUTS * EEG_DECIMATION)
+
+SAMPLE_SUB_DEFINE(quality_bench_sub, BIT(SAMPLE_TOPIC_QUALITY), 1,
+		  SAMPLE_DROP_OLDEST);
+
+static struct eeg_frame bench_frames[BENCH_FRAMES];
+static struct eeg_frame *bench_refs[BENCH_FRAMES];
+static struct eeg_block bench_in;
+static struct eeg_block bench_out;
+
+static float32_t bench_sine(float32_t freq, float32_t amplitude, uint32_t n)
+{
+	return amplitude * sinf(2.0f * PI * freq * n / EEG_OUTPUT_RATE);
+}
+
+static void bench_check_quality(const struct eeg_quality *quality)
+{
+	const struct eeg_channel_quality *mains = &quality->channel[0];
+	const struct eeg_channel_quality *railed = &quality->channel[1];
+	const float32_t ratio = BENCH_MAINS_AMPLITUDE * BENCH_MAINS_AMPLITUDE /
+				(BENCH_AMPLITUDE * BENCH_AMPLITUDE);
+
+	bench_check("mains line ratio", mains->line_ratio, ratio,
+		    0.1f * ratio);
+	bench_check("mains emg ratio", mains->emg_ratio, 0.0f, 0.1f);
+	bench_check("mains flags", mains->flags, QUALITY_LINE_NOISE, 0.0f);
+	bench_check("railed flags", railed->flags, QUALITY_RAILED, 0.0f);
+	bench_check("railed score", railed->score, 0.0f, 0.0f);
+	bench_check("railed frames", railed->railed,
+		    QUALITY_WINDOW * EEG_DECIMATION, 0.0f);
+}
+
+static int quality_bench(void)
+{
+	struct eeg_layout layout = { .num_channels = 2 };
+	uint8_t taken[BENCH_OUTPUTS];
+	struct sample_msg msg;
+	uint32_t n = 0;
+
+	// 채널 0은 코드 0, 채널 1은 레일 근처 코드 (24비트 빅엔디언)
+	for (int ch = 0; ch < layout.num_channels; ch++) {
+		layout.offset[ch] = EEG_STATUS_SIZE + ch * EEG_SAMPLE_SIZE;
+	}
+	for (uint32_t i = 0; i < BENCH_FRAMES; i++) {
+		uint8_t *rail = &bench_frames[i].data[layout.offset[1]];
+
+		memset(bench_frames[i].data, 0, sizeof(bench_frames[i].data));
+		rail[0] = BENCH_RAIL_CODE >> 16;
+		rail[1] = (BENCH_RAIL_CODE >> 8) & 0xff;
+		rail[2] = BENCH_RAIL_CODE & 0xff;
+		bench_refs[i] = &bench_frames[i];
+	}
+	// 데시메이터처럼 EEG_DECIMATION 프레임마다 마지막 프레임을 취함
+	for (uint32_t i = 0; i < BENCH_OUTPUTS; i++) {
+		taken[i] = (i + 1) * EEG_DECIMATION - 1;
+	}
+
+	sample_bus_subscribe(&quality_bench_sub);
+	quality_reset(layout.num_channels);
+	bench_in.num_channels = layout.num_channels;
+	bench_out.num_channels = layout.num_channels;
+
+	while (n < 2 * QUALITY_WINDOW) {
+		uint32_t count = MIN(BENCH_OUTPUTS, 2 * QUALITY_WINDOW - n);
+
+		bench_in.count = count;
+		bench_out.count = count;
+		bench_in.seq = n * EEG_DECIMATION;
+		for (uint32_t i = 0; i < count; i++, n++) {
+			float32_t eeg = bench_sine(BENCH_FREQ, BENCH_AMPLITUDE,
+						   n);
+			float32_t line = bench_sine(QUALITY_MAINS_FREQ,
+						    BENCH_MAINS_AMPLITUDE, n);
+
+			bench_in.samples[0][i] = bench_sample(eeg + line);
+			bench_in.samples[1][i] = bench_sample(eeg);
+			bench_out.samples[0][i] = bench_sample(eeg);
+			bench_out.samples[1][i] = bench_sample(eeg);
+		}
+		quality_push_raw(bench_refs, count * EEG_DECIMATION,
+				 EEG_DECIMATION > 1 ? taken : NULL, count,
+				 &layout);
+		quality_push(&bench_in, &bench_out);
+	}
+
+	if (sample_sub_get(&quality_bench_sub, &msg, K_NO_WAIT) != 0) {
+		LOG_ERR("No quality published after %d samples",
+			2 * QUALITY_WINDOW);
+	} else {
+		bench_check_quality(
+			CONTAINER_OF(msg.obj, struct eeg_quality, ref));
+		sample_ref_put(msg.obj);
+	}
+	sample_bus_unsubscribe(&quality_bench_sub);
+
+	return 0;
+}
+
+SYS_INIT(quality_bench, APPLICATION, BENCH_INIT_PRIORITY);
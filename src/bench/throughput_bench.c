@@ -0,0 +1,94 @@
+/*
+ * Boot-time CPU budget check: cycles per raw frame through the decoder, the
+ * decimator and the filter chain with every channel enabled, against one
+ * DRDY period. It runs in a tight loop before the stream starts, so it does
+ * not cover the frame queue, the bus, the radio or interrupt load, and is no
+ * proof that a sustained stream drops nothing; eeg_get_stats() tells that.
+ */
+#include "bench.h"
+#include "ti_ads1299_driver_spi.h"
+#include "../decimate.h"
+#include "../eeg.h"
+#include "../filter.h"
+#include "../frame_pool.h"
+#include "../unpack.h"
+
+#include <zephyr/init.h>
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+
+LOG_MODULE_REGISTER(throughput_bench, CONFIG_APP_LOG_LEVEL);
+
+// 측정할 블록 수 (필터 지연선이 충분히 채워지도록)
+#define BENCH_BLOCKS 64
+
+static struct eeg_frame bench_frames[EEG_BLOCK_FRAMES];
+static struct eeg_frame *bench_refs[EEG_BLOCK_FRAMES];
+static struct eeg_block bench_in;
+static struct eeg_block bench_out;
+
+// 처리 스레드와 같은 순서: 디코딩, 데시메이션, 필터
+static void bench_block(const struct eeg_layout *layout)
+{
+	unpack_frames(bench_refs, EEG_BLOCK_FRAMES, layout, &bench_in);
+#if EEG_DECIMATION > 1
+	uint8_t taken[EEG_BLOCK_FRAMES];
+
+	bench_in.count = decimate_process(bench_in.samples, bench_in.samples,
+					  EEG_BLOCK_FRAMES, taken);
+#endif
+	filteringEEGBlock(&bench_in, &bench_out);
+}
+
+static int throughput_bench(void)
+{
+	const uint32_t budget =
+		sys_clock_hw_cycles_per_sec() / CONFIG_TI_ADS1299_DATA_RATE_SPS;
+	struct eeg_layout layout = { .num_channels = EEG_MAX_CHANNELS };
+	uint8_t chnset[EEG_MAX_CHANNELS];
+	struct bench_timer timer;
+	uint32_t cycles;
+
+	for (int ch = 0; ch < EEG_MAX_CHANNELS; ch++) {
+		int dev = ch / EEG_CHANNELS_PER_DEVICE;
+		int pos = ch % EEG_CHANNELS_PER_DEVICE;
+
+		layout.offset[ch] = dev * EEG_DEVICE_FRAME_SIZE +
+				    EEG_STATUS_SIZE + EEG_SAMPLE_SIZE * pos;
+		chnset[ch] = ADS1299_REG_CHNSET_GAIN_24;
+	}
+	unpack_set_gains(chnset, EEG_MAX_CHANNELS);
+
+	// 부호가 섞인 합성 코드
+	for (uint32_t i = 0; i < EEG_BLOCK_FRAMES; i++) {
+		for (size_t b = 0; b < EEG_MAX_FRAME_SIZE; b++) {
+			bench_frames[i].data[b] = (uint8_t)(i * 37 + b * 11);
+		}
+		bench_refs[i] = &bench_frames[i];
+	}
+
+	decimate_reset(EEG_MAX_CHANNELS);
+	setFilterChannels(EEG_MAX_CHANNELS);
+
+	bench_start(&timer);
+	for (int b = 0; b < BENCH_BLOCKS; b++) {
+		bench_block(&layout);
+	}
+	cycles = bench_stop(&timer) / (BENCH_BLOCKS * EEG_BLOCK_FRAMES);
+
+	if (cycles >= budget) {
+		LOG_ERR("%d SPS, %d channels: %u cycles/frame, over the %u "
+			"cycle DRDY period",
+			CONFIG_TI_ADS1299_DATA_RATE_SPS, EEG_MAX_CHANNELS,
+			cycles, budget);
+	} else {
+		LOG_INF("%d SPS, %d channels: %u cycles/frame, %u%% of the "
+			"DRDY period",
+			CONFIG_TI_ADS1299_DATA_RATE_SPS, EEG_MAX_CHANNELS,
+			cycles, 100 * cycles / budget);
+	}
+
+	return 0;
+}
+
+SYS_INIT(throughput_bench, APPLICATION, BENCH_INIT_PRIORITY);
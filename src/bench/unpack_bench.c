@@ -0,0 +1,98 @@
+/*
+ * Boot-time comparison of the batch frame decoder against the per-sample
+ * byte decode it replaced, in CPU cycles per frame for 2, 4 and 8 channels.
+ */
+#include "bench.h"
+#include "ti_ads1299_driver_spi.h"
+#include "../eeg.h"
+#include "../frame_pool.h"
+#include "../unpack.h"
+
+#include <zephyr/init.h>
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+
+LOG_MODULE_REGISTER(unpack_bench, CONFIG_APP_LOG_LEVEL);
+
+// 블록마다 디코딩을 반복하는 횟수
+#define BENCH_ROUNDS 64
+
+static struct eeg_frame bench_frames[EEG_BLOCK_FRAMES];
+static struct eeg_frame *bench_refs[EEG_BLOCK_FRAMES];
+static struct eeg_block bench_out;
+
+// 기존 eeg.c 경로: 샘플마다 바이트 세 개를 읽고 EEG_GAIN 배율 적용
+static uint32_t bench_bytewise(const struct eeg_layout *layout)
+{
+	struct bench_timer timer;
+
+	bench_start(&timer);
+	for (int r = 0; r < BENCH_ROUNDS; r++) {
+		for (int ch = 0; ch < layout->num_channels; ch++) {
+			const uint16_t offset = layout->offset[ch];
+
+			for (uint32_t i = 0; i < EEG_BLOCK_FRAMES; i++) {
+				bench_out.samples[ch][i] = eeg_decode_sample(
+					&bench_refs[i]->data[offset]);
+			}
+		}
+	}
+
+	return bench_stop(&timer);
+}
+
+static uint32_t bench_unpack(const struct eeg_layout *layout)
+{
+	struct bench_timer timer;
+
+	bench_start(&timer);
+	for (int r = 0; r < BENCH_ROUNDS; r++) {
+		unpack_frames(bench_refs, EEG_BLOCK_FRAMES, layout, &bench_out);
+	}
+
+	return bench_stop(&timer);
+}
+
+static void bench_report(int num_channels)
+{
+	struct eeg_layout layout = { .num_channels = num_channels };
+	uint32_t bytewise, unpack;
+
+	// 첫 칩의 앞쪽 채널들
+	for (int ch = 0; ch < num_channels; ch++) {
+		layout.offset[ch] = EEG_STATUS_SIZE + EEG_SAMPLE_SIZE * ch;
+	}
+
+	bytewise = bench_bytewise(&layout);
+	unpack = bench_unpack(&layout);
+
+	LOG_INF("%d channels: bytewise %u, unpack %u cycles/frame",
+		num_channels, bytewise / (BENCH_ROUNDS * EEG_BLOCK_FRAMES),
+		unpack / (BENCH_ROUNDS * EEG_BLOCK_FRAMES));
+}
+
+static int unpack_bench(void)
+{
+	uint8_t chnset[EEG_CHANNELS_PER_DEVICE];
+
+	// 부호가 섞인 합성 코드
+	for (uint32_t i = 0; i < EEG_BLOCK_FRAMES; i++) {
+		for (size_t b = 0; b < EEG_MAX_FRAME_SIZE; b++) {
+			bench_frames[i].data[b] = (uint8_t)(i * 37 + b * 11);
+		}
+		bench_refs[i] = &bench_frames[i];
+	}
+
+	for (int ch = 0; ch < EEG_CHANNELS_PER_DEVICE; ch++) {
+		chnset[ch] = ADS1299_REG_CHNSET_GAIN_24;
+	}
+	unpack_set_gains(chnset, EEG_CHANNELS_PER_DEVICE);
+
+	bench_report(2);
+	bench_report(4);
+	bench_report(8);
+
+	return 0;
+}
+
+SYS_INIT(unpack_bench, APPLICATION, BENCH_INIT_PRIORITY);
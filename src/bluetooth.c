@@ -12,7 +12,11 @@
  */
 #include "bluetooth.h"
 #include "eeg.h"
+#include "eeg_features.h"
+#include "frame_pool.h"
+#include "sample_bus.h"
 
+#include <string.h>
 #include <zephyr/kernel.h>
 #include <zephyr/bluetooth/addr.h>
 #include <zephyr/bluetooth/bluetooth.h>
@@ -22,6 +26,7 @@
 #include <zephyr/bluetooth/hci.h>
 #include <zephyr/bluetooth/uuid.h>
 #include <zephyr/logging/log.h>
+#include <zephyr/sys/byteorder.h>
 
 /* Structure for generating a BLE notify event (kernel API). */
 struct k_event bt_event;
@@ -337,6 +342,17 @@ SYS_INIT(bt_setup, APPLICATION, CONFIG_APPLICATION_INIT_PRIORITY);
 /* Flag for transmitting only when notify is enabled. */
 static bool bt_notify_enable = false;
 
+#ifdef CONFIG_APP_BT_STREAM_FEATURES
+/* Feature frames waiting for the radio, a stalled link keeps the newest */
+SAMPLE_SUB_DEFINE(ble_sub, BIT(SAMPLE_TOPIC_FEATURES), 2, SAMPLE_DROP_OLDEST);
+#else
+/*
+ * Raw frames waiting for the radio. A stalled link drops the newest frames,
+ * counted as transport drops; the depth is part of EEG_POOL_BUS_FRAMES.
+ */
+SAMPLE_SUB_DEFINE(ble_sub, BIT(SAMPLE_TOPIC_RAW), 64, SAMPLE_DROP_NEWEST);
+#endif
+
 /**
  * @brief Callback function for Gas Sensor CCC (Client Characteristic Configuration) changes.
  *
@@ -353,6 +369,13 @@ static void mylbsbc_ccc_gas_cfg_changed(const struct bt_gatt_attr *attr,
 	/* Update the notify_gas_enabled flag */
 	bt_notify_enable = (value == BT_GATT_CCC_NOTIFY);
 
+	/* Only take data off the sample bus while someone listens */
+	if (bt_notify_enable) {
+		sample_bus_subscribe(&ble_sub);
+	} else {
+		sample_bus_unsubscribe(&ble_sub);
+	}
+
 	/* Log the change in the CCC descriptor */
 	LOG_INF("notify cfg changed %d", bt_notify_enable);
 }
@@ -392,43 +415,174 @@ BT_GATT_SERVICE_DEFINE(
 	BT_GATT_CCC(mylbsbc_ccc_gas_cfg_changed,
 		    BT_GATT_PERM_READ | BT_GATT_PERM_WRITE));
 
-static int bt_notify(char *data)
+static int bt_notify(const uint8_t *data, uint16_t len, uint32_t frames)
+{
+	LOG_HEXDUMP_DBG(data, len, "notify");
+
+	int err = bt_gatt_notify(NULL, &bt_hhs_svc.attrs[4], (void *)data,
+				 (size_t)len);
+	if (err) {
+		eeg_count_transport_drops(frames);
+	}
+
+	return err;
+}
+
+/* Fill in the eeg_packet_hdr at the start of a notification */
+static void bt_packet_hdr(uint8_t *packet, uint32_t seq, uint32_t first_cycles)
 {
-	uint8_t data_length = 3;
-	LOG_HEXDUMP_INF(data, data_length, "notify");
+	uint32_t waited = k_cycle_get_32() - first_cycles;
 
-	return bt_gatt_notify(NULL, &bt_hhs_svc.attrs[4], (void *)data,
-			      (size_t)data_length);
+	sys_put_le32(seq, &packet[offsetof(struct eeg_packet_hdr, seq)]);
+	sys_put_le32(k_cyc_to_us_floor32(waited),
+		     &packet[offsetof(struct eeg_packet_hdr, transport_us)]);
+	sys_put_le32(eeg_latency_us(),
+		     &packet[offsetof(struct eeg_packet_hdr, pipeline_us)]);
 }
 
-extern uint8_t data[15];
+#ifdef CONFIG_APP_BT_STREAM_FEATURES
+/* Band records that fit in one notification behind the headers */
+#define BT_FEATURES_OFFSET \
+	(sizeof(struct eeg_packet_hdr) + sizeof(struct eeg_features_hdr))
+#define BT_FEATURES_CHANNELS                       \
+	((EEG_NOTIFY_MAX_LEN - BT_FEATURES_OFFSET) / \
+	 sizeof(struct eeg_band_record))
+
+/*
+ * Send a feature frame as eeg_packet_hdr, eeg_features_hdr and the band
+ * records of as many channels as fit, in as many notifications as it takes.
+ */
+static void bt_stream_features(uint8_t *packet,
+			       const struct eeg_features *features)
+{
+	const uint32_t received = k_cycle_get_32();
+
+	for (int first = 0; first < features->num_channels;
+	     first += BT_FEATURES_CHANNELS) {
+		int n = MIN(features->num_channels - first,
+			    BT_FEATURES_CHANNELS);
+		uint8_t *hdr = &packet[sizeof(struct eeg_packet_hdr)];
+
+		bt_packet_hdr(packet, features->seq, received);
+		hdr[offsetof(struct eeg_features_hdr, first_channel)] = first;
+		hdr[offsetof(struct eeg_features_hdr, num_channels)] = n;
+		for (int i = 0; i < n; i++) {
+			eeg_features_pack(
+				features, first + i,
+				&packet[BT_FEATURES_OFFSET +
+					i * sizeof(struct eeg_band_record)]);
+		}
+		bt_notify(packet,
+			  BT_FEATURES_OFFSET +
+				  n * sizeof(struct eeg_band_record),
+			  0);
+	}
+}
+#else
+/* Raw frames collected for the next notification */
+static struct {
+	/* Layout of the frames collected, see eeg_frame_hdr::generation */
+	struct eeg_layout layout;
+	uint32_t first_seq;
+	uint32_t first_cycles;
+	size_t frames;
+	uint32_t last_drops;
+} bt_raw;
+
+/* Send the frames collected so far, if any */
+static void bt_raw_flush(uint8_t *packet)
+{
+	if (bt_raw.frames == 0) {
+		return;
+	}
+
+	bt_packet_hdr(packet, bt_raw.first_seq, bt_raw.first_cycles);
+	bt_notify(packet,
+		  sizeof(struct eeg_packet_hdr) +
+			  bt_raw.layout.packet_size * bt_raw.frames,
+		  bt_raw.frames);
+	bt_raw.frames = 0;
+
+	/* Frames the bus dropped for us count as transport drops */
+	uint32_t drops = atomic_get(&ble_sub.drops);
+
+	eeg_count_transport_drops(drops - bt_raw.last_drops);
+	bt_raw.last_drops = drops;
+}
+
+/*
+ * Pack a raw frame behind the eeg_packet_hdr, and send the packet once
+ * eeg_layout::frames_per_packet frames are collected. The first frame of a
+ * new layout sends the frames of the old one first; frames still queued
+ * from before a layout change can no longer be packed and are dropped.
+ */
+static void bt_stream_frame(uint8_t *packet, const struct eeg_frame *frame)
+{
+	int32_t age = frame->hdr.generation - bt_raw.layout.generation;
+	uint8_t *dst;
+
+	if (age > 0) {
+		bt_raw_flush(packet);
+		eeg_get_layout(&bt_raw.layout);
+		age = frame->hdr.generation - bt_raw.layout.generation;
+	}
+	if (age != 0) {
+		eeg_count_transport_drops(1);
+		return;
+	}
+
+	if (sizeof(struct eeg_packet_hdr) +
+		    (bt_raw.frames + 1) * bt_raw.layout.packet_size >
+	    EEG_NOTIFY_MAX_LEN) {
+		bt_raw_flush(packet);
+	}
+	dst = &packet[sizeof(struct eeg_packet_hdr) +
+		      bt_raw.frames * bt_raw.layout.packet_size];
+
+	if (bt_raw.frames == 0) {
+		bt_raw.first_seq = frame->hdr.seq;
+		bt_raw.first_cycles = k_cycle_get_32();
+	}
+
+	for (int ch = 0; ch < bt_raw.layout.num_channels; ch++) {
+		memcpy(&dst[ch * EEG_SAMPLE_SIZE],
+		       &frame->data[bt_raw.layout.offset[ch]], EEG_SAMPLE_SIZE);
+	}
+
+	if (++bt_raw.frames >= bt_raw.layout.frames_per_packet) {
+		bt_raw_flush(packet);
+	}
+}
+#endif
 
 /**
  * @brief Bluetooth thread function.
  *
- * This function is the entry point for the Bluetooth thread. It initializes the Bluetooth stack,
- * starts advertising, and handles Bluetooth notifications. It also converts the firmware build time
- * to the time_t format for adding it to the current kernel time (k_uptime_get()). It periodically
- * sends notifications if a client is subscribed and gas sensor data is available. The function
- * constructs the notification data, including gas sensor values, battery percentage, and, if
- * enabled, environmental sensor data (temperature, pressure, humidity, IAQ, eCO2, and breath VOC).
+ * Streams raw EEG frames taken from the sample bus. The 24-bit samples of
+ * the active channels are packed frame after frame behind an eeg_packet_hdr,
+ * and a notification is sent once eeg_layout::frames_per_packet frames are
+ * collected. The header tags the packet with its first sequence number and
+ * the latency the host needs to line it up with on-device processing. With
+ * CONFIG_APP_BT_STREAM_FEATURES only the band power frames are sent.
  *
- * @note The function sends notifications only if a client is subscribed.
+ * @note Data is only received while a client has notifications enabled.
  */
 static void bluetooth_thread(void)
 {
+	static uint8_t packet[EEG_NOTIFY_MAX_LEN];
+	struct sample_msg msg;
+
 	while (1) {
-		k_msleep(1000);
-		// uint32_t bluetooth_events =
-		// 	k_event_wait(&bt_event, bt_tx_event_sum, true,
-		// 		     K_SECONDS(TIMEOUT_SEC));
-		//
-		// /* Check if gas notification is enabled */
-		// if (!bt_notify_enable) {
-		// 	continue;
-		// }
-		//
-		// bt_notify(&data[3]);
+		sample_sub_get(&ble_sub, &msg, K_FOREVER);
+#ifdef CONFIG_APP_BT_STREAM_FEATURES
+		bt_stream_features(packet, CONTAINER_OF(msg.obj,
+							struct eeg_features,
+							ref));
+#else
+		bt_stream_frame(packet,
+				CONTAINER_OF(msg.obj, struct eeg_frame, ref));
+#endif
+		sample_ref_put(msg.obj);
 	}
 }
 
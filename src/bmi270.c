@@ -1,3 +1,6 @@
+#include "imu.h"
+
+#include <stddef.h>
 #include <zephyr/kernel.h>
 #include <zephyr/device.h>
 #include <zephyr/drivers/sensor.h>
@@ -9,17 +12,26 @@ LOG_MODULE_REGISTER(BMI270, CONFIG_APP_LOG_LEVEL);
 
 static const struct device *bmi270_dev = DEVICE_DT_GET(BMI270_NODE);
 static struct k_sem data_ready_sem;
+static int64_t data_ready_uptime;
+
+/* Samples in flight between this thread and sample bus subscribers */
+#define IMU_SAMPLE_BLOCKS 8
+BUILD_ASSERT(offsetof(struct imu_sample, ref) == 0,
+	     "pool blocks are freed through their sample_ref");
+K_MEM_SLAB_DEFINE_STATIC(imu_slab, sizeof(struct imu_sample), IMU_SAMPLE_BLOCKS,
+			 sizeof(uint32_t));
 
 static void bmi270_trigger_handler(const struct device *bmi270_dev,
 				   const struct sensor_trigger *trig)
 {
+	data_ready_uptime = k_uptime_get();
 	k_sem_give(&data_ready_sem);
 }
 
 void bmi270_thread(void)
 {
 	int ret;
-	struct sensor_value accel[3], gyro[3];
+	struct imu_sample *sample;
 	struct sensor_value full_scale, sampling_freq, oversampling;
 
 	if (!device_is_ready(bmi270_dev)) {
@@ -90,16 +102,20 @@ void bmi270_thread(void)
 			continue;
 		}
 
-		sensor_channel_get(bmi270_dev, SENSOR_CHAN_ACCEL_XYZ, accel);
-		sensor_channel_get(bmi270_dev, SENSOR_CHAN_GYRO_XYZ, gyro);
-
-		// Process and print data
-		LOG_INF("AX: %d.%06d; AY: %d.%06d; AZ: %d.%06d; "
-			"GX: %d.%06d; GY: %d.%06d; GZ: %d.%06d;",
-			accel[0].val1, accel[0].val2, accel[1].val1,
-			accel[1].val2, accel[2].val1, accel[2].val2,
-			gyro[0].val1, gyro[0].val2, gyro[1].val1, gyro[1].val2,
-			gyro[2].val1, gyro[2].val2);
+		/* Nobody listening, or every subscriber still holds its blocks */
+		if (!sample_bus_has_subscribers(SAMPLE_TOPIC_IMU) ||
+		    k_mem_slab_alloc(&imu_slab, (void **)&sample, K_NO_WAIT)) {
+			continue;
+		}
+		sample_ref_init(&sample->ref, &imu_slab);
+		sample->uptime = data_ready_uptime;
+		sensor_channel_get(bmi270_dev, SENSOR_CHAN_ACCEL_XYZ,
+				   sample->accel);
+		sensor_channel_get(bmi270_dev, SENSOR_CHAN_GYRO_XYZ,
+				   sample->gyro);
+
+		sample_bus_publish(SAMPLE_TOPIC_IMU, &sample->ref);
+		sample_ref_put(&sample->ref);
 	}
 }
 
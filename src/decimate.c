@@ -0,0 +1,106 @@
+#include "decimate.h"
+#include "filter.h"
+
+#include <string.h>
+#include <zephyr/init.h>
+
+BUILD_ASSERT(CONFIG_TI_ADS1299_DATA_RATE_SPS % EEG_OUTPUT_RATE == 0,
+	     "the ADS1299 data rate must be a multiple of the output rate");
+BUILD_ASSERT(EEG_DECIMATION <= 16, "decimation is limited to 16");
+
+#if EEG_DECIMATION > 1
+#define DECIMATE_TAPS (DECIMATE_ORDER + 1)
+
+/*
+ * Polyphase decimation over every active channel: input frames are pushed
+ * into a circular buffer of rows like the FIR bank in filter.c and summed
+ * by the same fir_rows_*() helpers, only at the frames that are kept.
+ * CMSIS-DSP arm_fir_decimate_* is not used because it needs blocks in
+ * multiples of the decimation factor, and blocks split where the frame queue
+ * wraps.
+ */
+static float32_t coeffs[DECIMATE_TAPS];
+#ifdef CONFIG_APP_EEG_Q31
+// 64-bit accumulator, the q31 taps sum to one so no guard bits are used up
+typedef q63_t decimate_acc_t;
+static q31_t coeffs_q31[DECIMATE_TAPS];
+#else
+typedef float32_t decimate_acc_t;
+#endif
+
+// Rows of every active channel, the newest at pos
+static eeg_sample_t delay[DECIMATE_TAPS * EEG_MAX_CHANNELS];
+static uint16_t pos;
+// Frames pushed since the last kept one
+static uint8_t phase;
+static int channels;
+
+// Output frame n = sum(coeffs[k] * x[ch][pos - k]) of every channel
+static void decimate_row(eeg_sample_t output[][EEG_BLOCK_FRAMES], size_t n)
+{
+	const int nch = channels;
+	decimate_acc_t acc[EEG_MAX_CHANNELS] = { 0 };
+
+#ifdef CONFIG_APP_EEG_Q31
+	fir_rows_q31(acc, delay, coeffs_q31, DECIMATE_TAPS, pos, nch);
+#else
+	fir_rows_f32(acc, delay, coeffs, DECIMATE_TAPS, pos, nch);
+#endif
+
+	for (int ch = 0; ch < nch; ch++) {
+#ifdef CONFIG_APP_EEG_Q31
+		output[ch][n] = (q31_t)(acc[ch] >> 31);
+#else
+		output[ch][n] = acc[ch];
+#endif
+	}
+}
+
+void decimate_reset(int num_channels)
+{
+	channels = num_channels;
+	pos = 0;
+	phase = 0;
+	memset(delay, 0, DECIMATE_TAPS * num_channels * sizeof(delay[0]));
+}
+
+size_t decimate_process(const eeg_sample_t input[][EEG_BLOCK_FRAMES],
+			eeg_sample_t output[][EEG_BLOCK_FRAMES], size_t count,
+			uint8_t *taken)
+{
+	const int nch = channels;
+	size_t n = 0;
+
+	for (size_t i = 0; i < count; i++) {
+		eeg_sample_t *newest = &delay[pos * nch];
+
+		for (int ch = 0; ch < nch; ch++) {
+			newest[ch] = input[ch][i];
+		}
+
+		// n <= i이므로 입력 프레임을 옮긴 뒤에는 같은 블록에 써도 됨
+		if (++phase == EEG_DECIMATION) {
+			phase = 0;
+			decimate_row(output, n);
+			taken[n++] = i;
+		}
+		pos = (pos + 1 == DECIMATE_TAPS) ? 0 : pos + 1;
+	}
+
+	return n;
+}
+
+static int decimate_init(void)
+{
+	calculate_lp_coeffs(coeffs, DECIMATE_ORDER, DECIMATE_CUTOFF,
+			    CONFIG_TI_ADS1299_DATA_RATE_SPS);
+#ifdef CONFIG_APP_EEG_Q31
+	arm_float_to_q31(coeffs, coeffs_q31, DECIMATE_TAPS);
+#endif
+	decimate_reset(EEG_MAX_CHANNELS);
+
+	return 0;
+}
+
+SYS_INIT(decimate_init, APPLICATION, CONFIG_APPLICATION_INIT_PRIORITY);
+#endif
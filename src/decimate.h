@@ -0,0 +1,49 @@
+#ifndef __APP_DECIMATE_H__
+#define __APP_DECIMATE_H__
+
+#include "eeg.h"
+
+#include <stddef.h>
+#include <stdint.h>
+#include <zephyr/toolchain.h>
+
+/*
+ * Anti-alias low-pass in front of the decimation, in input samples. The
+ * passband ends at 0.4 of the output rate and the Blackman transition of
+ * 28 taps per decimation step closes before the output Nyquist frequency.
+ */
+#define DECIMATE_ORDER (28 * EEG_DECIMATION)
+#define DECIMATE_CUTOFF (0.4f * EEG_OUTPUT_RATE)
+
+#if EEG_DECIMATION > 1
+/** @brief Clear the delay lines and phase of num_channels channels. */
+void decimate_reset(int num_channels);
+
+/**
+ * @brief Low-pass and keep every EEG_DECIMATION-th frame of a planar block.
+ *
+ * The phase carries over between calls, so @p count need not be a multiple
+ * of EEG_DECIMATION. Only the kept frames are computed. @p input and
+ * @p output may be the same block.
+ *
+ * @param[out] taken Index in @p input of the frame each output was taken at.
+ *
+ * @return Number of output frames written.
+ */
+size_t decimate_process(const eeg_sample_t input[][EEG_BLOCK_FRAMES],
+			eeg_sample_t output[][EEG_BLOCK_FRAMES], size_t count,
+			uint8_t *taken);
+#else
+static inline void decimate_reset(int num_channels)
+{
+	ARG_UNUSED(num_channels);
+}
+#endif
+
+/** @brief Group delay of the decimator, in input samples. */
+static inline float32_t decimate_group_delay(void)
+{
+	return EEG_DECIMATION > 1 ? DECIMATE_ORDER / 2.0f : 0.0f;
+}
+
+#endif // __APP_DECIMATE_H__
@@ -1,41 +1,74 @@
 #include "ti_ads1299_driver_spi.h"
+#include "decimate.h"
 #include "eeg.h"
+#include "epoch.h"
 #include "filter.h"
+#include "frame_pool.h"
+#include "frame_queue.h"
+#include "quality.h"
+#include "sample_bus.h"
+#include "unpack.h"
 
 #include <stdio.h>
+#include <string.h>
 #include <zephyr/kernel.h>
 #include <zephyr/device.h>
 #include <zephyr/devicetree.h>
 #include <zephyr/drivers/spi.h>
 #include <zephyr/logging/log.h>
-#include <zephyr/sys/ring_buffer.h>
+#ifdef CONFIG_SHELL
+#include <zephyr/shell/shell.h>
+#endif
 
 #define ADS1299_NODE DT_NODELABEL(ads1299)
 
 LOG_MODULE_REGISTER(EEG, CONFIG_APP_LOG_LEVEL);
 
-// ADS1299 관련 상수
-const float VREF = 4.5f; // 기준 전압 (V)
-const int GAIN = 24; // PGA 게인
-const int RESOLUTION = 24; // ADC 해상도 (비트)
-
 const struct device *ads1299_spi_dev = DEVICE_DT_GET(DT_NODELABEL(ads1299));
 
 static K_SEM_DEFINE(drdy_sem, 0, 1);
 static struct gpio_callback drdy_cb_data;
 
-#define DATA_SIZE 15
-#define RING_BUF_SIZE 1024
+// BLE 알림 하나에 묶을 샘플 수 (ATT 페이로드와 전송 지연 한도)
+#define EEG_TX_PAYLOAD (EEG_NOTIFY_MAX_LEN - sizeof(struct eeg_packet_hdr))
+#define EEG_TX_LATENCY_MS 50
+
+// 처리 대기 중인 프레임 참조 (풀 전체를 담는 2의 거듭제곱 크기)
+FRAME_QUEUE_DEFINE(eeg_queue, sizeof(struct eeg_frame *),
+		   (uint32_t)NHPOT(EEG_POOL_FRAMES));
+
+// 활성 채널 (재설정 시에도 유지되는 CHnSET 값, 부팅 시 게인은 EEG_GAIN)
+#define EEG_CHNSET \
+	(ADS1299_REG_CHNSET_GAIN_24 | ADS1299_REG_CHNSET_INPUT_SHORTED)
 
-static uint8_t ring_buffer_data[RING_BUF_SIZE];
-static struct ring_buf ring_buf;
+static struct eeg_layout layout;
+// 레이아웃 변경과 폴링 모드의 프레임 읽기를 직렬화
+static K_MUTEX_DEFINE(layout_lock);
+// 처리 스레드가 쓰는 레이아웃 사본 (처리 중인 프레임의 세대)
+static struct eeg_layout proc_layout;
 
 K_SEM_DEFINE(data_ready_sem, 0, 1);
 
+// 파이프라인 단계별 카운터 (ISR과 스레드에서 갱신, eeg_stats 참고)
+static struct {
+	atomic_t drdy;
+	atomic_t reads;
+	atomic_t read_errors;
+	atomic_t overruns;
+	atomic_t processed;
+	atomic_t processing_drops;
+	atomic_t gaps;
+	atomic_t transport_drops;
+} counters;
+
+// 큐를 비운 뒤 처리 단계가 시퀀스 번호를 다시 맞추도록 함
+static atomic_t seq_resync = ATOMIC_INIT(1);
+
 // DRDY 인터럽트 핸들러
 static void drdy_handler(const struct device *dev, struct gpio_callback *cb,
 			 uint32_t pins)
 {
+	atomic_inc(&counters.drdy);
 	k_sem_give(&drdy_sem);
 }
 
@@ -78,64 +111,455 @@ static int ads1299_init(void)
 		return ret;
 	}
 
+	// DRDY 엣지를 하드웨어 타임스탬프 타이머에 연결 (GPIOTE 채널 할당 후)
+	ret = ti_ads1299_timestamp_enable(ads1299_spi_dev);
+	if (ret != 0 && ret != -ENOTSUP) {
+		LOG_WRN("DRDY timestamps unavailable: %d", ret);
+	}
+
 	LOG_INF("ADS1299 DRDY interrupt initialized");
 	return 0;
 }
 
-// float32_t adc_to_voltage(int32_t adc_code)
-// {
-//
-// 	// 2의 보수 형태의 ADC 코드를 부호 있는 정수로 변환
-// 	if (adc_code > 0x7FFFFF) {
-// 		adc_code -= 0x1000000;
-// 	}
-//
-// 	// 전압 계산 (오버플로우 방지를 위해 순서 조정)
-// 	float32_t voltage = ((float32_t)adc_code * VREF) / (float32_t)GAIN;
-// 	voltage /= (float32_t)(1 << (RESOLUTION - 1));
-//
-// 	return voltage;
-// }
+// 채널 마스크로부터 프레임 디코더/전송 크기 계산
+static void layout_update(uint8_t mask)
+{
+	uint8_t n = 0;
+
+	// 데이지 체인의 칩마다 같은 마스크, 칩 순서대로 한 프레임에 이어짐
+	for (int device = 0; device < EEG_NUM_DEVICES; device++) {
+		for (int channel = 0; channel < EEG_CHANNELS_PER_DEVICE;
+		     channel++) {
+			if (mask & BIT(channel)) {
+				layout.offset[n++] =
+					device * EEG_DEVICE_FRAME_SIZE +
+					EEG_STATUS_SIZE +
+					EEG_SAMPLE_SIZE * channel;
+			}
+		}
+	}
+
+	layout.channel_mask = mask;
+	layout.num_channels = n;
+	// 마지막 칩의 마지막 활성 채널 이후 바이트는 SPI로 읽지 않음
+	layout.frame_size = layout.offset[n - 1] + EEG_SAMPLE_SIZE;
+	layout.packet_size = EEG_SAMPLE_SIZE * n;
+	layout.frames_per_packet =
+		MIN(EEG_TX_PAYLOAD / layout.packet_size,
+		    MAX(1, EEG_OUTPUT_RATE * EEG_TX_LATENCY_MS / 1000));
+	layout.generation++;
+}
 
-// ADS1299에서 읽은 24비트 ADC 값을 실제 전압으로 변환하는 함수
-float32_t adc_to_voltage(int32_t adc_value)
+// 활성 채널의 CHnSET을 레이아웃에 반영 (디코더 배율은 처리 스레드가 갱신)
+static void gains_update(void)
 {
-	// ADC 값이 24비트 2의 보수 형식이므로, 부호 확장
-	if (adc_value & 0x800000) {
-		adc_value |= 0xFF000000;
+	uint8_t chnset[EEG_CHANNELS_PER_DEVICE];
+	uint8_t n = 0;
+	int err;
+
+	// 섀도에는 첫 칩의 값이 있고, 쓰기는 체인의 모든 칩에 같게 적용됨
+	err = ti_ads1299_read_regs(ads1299_spi_dev, ADS1299_REG_CH1SET, chnset,
+				   ARRAY_SIZE(chnset));
+	if (err == 0) {
+		for (int device = 0; device < EEG_NUM_DEVICES; device++) {
+			for (int channel = 0; channel < EEG_CHANNELS_PER_DEVICE;
+			     channel++) {
+				if (layout.channel_mask & BIT(channel)) {
+					layout.chnset[n++] = chnset[channel];
+				}
+			}
+		}
+		layout.generation++;
+	} else {
+		LOG_ERR("Error reading channel gains, err: %d", err);
 	}
+}
 
-	// ADC 값을 전압으로 변환
-	float32_t voltage =
-		(float32_t)adc_value * (2 * VREF) / (pow(2, 23) - 1) / GAIN;
+void eeg_get_layout(struct eeg_layout *copy)
+{
+	k_mutex_lock(&layout_lock, K_FOREVER);
+	*copy = layout;
+	k_mutex_unlock(&layout_lock);
+}
 
-	return voltage;
+// 연속된 DRDY 타임스탬프 간격의 명목 주기 대비 최대 편차를 1초마다 보고
+static void track_drdy_jitter(uint32_t timestamp)
+{
+	static uint32_t last_timestamp;
+	static uint32_t max_dev;
+	static uint32_t frames;
+	const uint32_t sps = ti_ads1299_get_data_rate(ads1299_spi_dev);
+	const uint32_t period = TI_ADS1299_TIMESTAMP_HZ / sps;
+
+	if (frames > 0) {
+		uint32_t delta = timestamp - last_timestamp;
+		uint32_t deviation = delta > period ? delta - period :
+						     period - delta;
+
+		max_dev = MAX(max_dev, deviation);
+	}
+	last_timestamp = timestamp;
+
+	if (++frames >= sps) {
+		LOG_DBG("DRDY jitter %u ns",
+			(uint32_t)((uint64_t)max_dev * NSEC_PER_SEC /
+				   TI_ADS1299_TIMESTAMP_HZ));
+		max_dev = 0;
+		frames = 1;
+	}
 }
 
-void process_and_print_data(const uint8_t *data, size_t size)
+// 시퀀스 번호가 건너뛴 만큼 누락으로 집계
+static void track_seq(uint32_t seq)
 {
-	float32_t voltage[2] = { 0.0 };
-	for (int channel = 0; channel < 2; channel++) {
-		int32_t value = (data[3 * channel + 3] << 16) |
-				(data[3 * channel + 4] << 8) |
-				data[3 * channel + 5];
+	static uint32_t expected;
+
+	if (!atomic_cas(&seq_resync, 1, 0)) {
+		int32_t missing = (int32_t)(seq - expected);
 
-		float32_t volt = adc_to_voltage(value);
-		voltage[channel] = filteringEEGData(volt, channel);
+		if (missing > 0) {
+			atomic_add(&counters.gaps, missing);
+		}
 	}
+	expected = seq + 1;
+}
 
-	printk("%f\n", voltage[0]);
+// 채널별 블록 (프레임 순서로 쌓인 샘플을 채널 단위로 풀어 둠)
+static struct eeg_block block_in;
+// 필터 출력을 받을 구독자가 없거나 블록이 모자랄 때 쓰는 출력 버퍼
+static struct eeg_block block_out;
+
+#if EEG_DECIMATION > 1
+// 데시메이션된 샘플을 취한 프레임에 다시 써서 출력 속도의 원시 스트림으로 발행
+// (데시메이션 중에는 수집 단계가 프레임을 발행하지 않아 다른 참조가 없음)
+static void publish_decimated(struct eeg_frame *const *frames,
+			      const uint8_t *taken)
+{
+	for (uint32_t i = 0; i < block_in.count; i++) {
+		struct eeg_frame *frame = frames[taken[i]];
+
+		unpack_encode(&block_in, i, &proc_layout, frame->data);
+		sample_bus_publish(SAMPLE_TOPIC_RAW, &frame->ref);
+	}
 }
+#endif
 
-static void data_processing_thread(void *arg1, void *arg2, void *arg3)
+// 연속된 count(<= EEG_BLOCK_FRAMES)개 프레임을 채널별 블록으로 한 번에 필터링
+static void process_block(struct eeg_frame *const *frames, uint32_t count)
+{
+	struct eeg_filtered *filtered = NULL;
+	struct eeg_block *out = &block_out;
+
+	for (uint32_t i = 0; i < count; i++) {
+		track_seq(frames[i]->hdr.seq);
+		if (IS_ENABLED(CONFIG_TI_ADS1299_TIMESTAMP)) {
+			track_drdy_jitter(frames[i]->hdr.timestamp);
+		}
+	}
+	atomic_add(&counters.processed, count);
+
+	unpack_frames(frames, count, &proc_layout, &block_in);
+
+#if EEG_DECIMATION > 1
+	uint8_t taken[EEG_BLOCK_FRAMES];
+
+	// 이후 단계는 모두 출력 속도로 동작
+	block_in.count = decimate_process(block_in.samples, block_in.samples,
+					  count, taken);
+	// publish_decimated()가 프레임을 덮어쓰기 전에 원시 코드를 집계
+	quality_push_raw(frames, count, taken, block_in.count, &proc_layout);
+	if (block_in.count == 0) {
+		return;
+	}
+	// 블록은 첫 출력 샘플이 나온 프레임에서 시작
+	block_in.seq = frames[taken[0]]->hdr.seq;
+	block_in.timestamp = frames[taken[0]]->hdr.timestamp;
+	publish_decimated(frames, taken);
+#else
+	quality_push_raw(frames, count, NULL, count, &proc_layout);
+#endif
+
+	// 구독자가 있으면 발행할 블록에 바로 필터링
+	if (sample_bus_has_subscribers(SAMPLE_TOPIC_FILTERED)) {
+		filtered = eeg_filtered_alloc();
+		if (filtered != NULL) {
+			out = &filtered->block;
+		}
+	}
+
+	filteringEEGBlock(&block_in, out);
+	epoch_push(out);
+	quality_push(&block_in, out);
+
+	if (filtered != NULL) {
+		filtered->latency_us = eeg_latency_us();
+		sample_bus_publish(SAMPLE_TOPIC_FILTERED, &filtered->ref);
+		sample_ref_put(&filtered->ref);
+	}
+}
+
+// 부팅 후 첫 샘플까지 걸린 시간을 한 번만 보고 (frames_ago: 이미 지난 프레임 수)
+static void report_first_sample(size_t frames_ago)
 {
-	uint8_t data[DATA_SIZE];
+	static bool reported;
+
+	if (reported) {
+		return;
+	}
+	reported = true;
+
+	LOG_INF("First sample %u ms after boot",
+		k_uptime_get_32() -
+			frames_ago * MSEC_PER_SEC /
+				ti_ads1299_get_data_rate(ads1299_spi_dev));
+}
+
+// 큐가 가득 차서 넣지 못한 프레임 집계
+static void count_overrun(uint32_t seq, uint32_t frames)
+{
+	atomic_add(&counters.overruns, frames);
+	LOG_WRN("Frame queue full, %u frames lost from %u", frames, seq);
+}
+
+// 재설정으로 읽지 못한 DRDY 주기를 시퀀스 번호에 반영 (스트림 모드)
+static void count_skipped(uint32_t skipped)
+{
+	if (IS_ENABLED(CONFIG_TI_ADS1299_DPPI_STREAM)) {
+		atomic_add(&counters.drdy, skipped);
+	}
+}
+
+// DPPI 스트림 블록 완료 핸들러 (TIMER 인터럽트 컨텍스트, N 프레임마다 1회)
+static void eeg_stream_handler(const struct device *dev, const uint8_t *frames,
+			       const uint32_t *timestamps, size_t count,
+			       uint32_t drdy, void *user_data)
+{
+	// drdy는 하드웨어가 센 DRDY 수, 읽지 못한 변환은 블록 앞의 빈 번호로 남음
+	uint32_t seq = atomic_add(&counters.drdy, drdy) + drdy - count;
+
+	// 스트림을 멈춘 동안에만 레이아웃이 바뀜
+	size_t size = layout.frame_size;
+	uint32_t generation = layout.generation;
+	uint32_t done = 0;
+
+	atomic_add(&counters.reads, count);
+	report_first_sample(count - 1);
+
+	// DMA 버퍼는 곧 다시 채워지므로 풀 블록으로 한 번만 복사
+	while (done < count) {
+		uint32_t n, i;
+		struct eeg_frame **slots = frame_queue_claim(&eeg_queue, &n);
+
+		n = MIN(n, count - done);
+		for (i = 0; i < n; i++, done++) {
+			struct eeg_frame *frame = eeg_frame_alloc();
+
+			if (frame == NULL) {
+				break;
+			}
+			frame->hdr.seq = seq + done;
+			frame->hdr.timestamp =
+				timestamps != NULL ? timestamps[done] : 0;
+			frame->hdr.generation = generation;
+			memcpy(frame->data, &frames[done * size], size);
+			slots[i] = frame;
+			// 데시메이션 중에는 처리 스레드가 출력 속도로 발행
+			if (EEG_DECIMATION == 1) {
+				sample_bus_publish(SAMPLE_TOPIC_RAW,
+						   &frame->ref);
+			}
+		}
+		frame_queue_commit(&eeg_queue, i);
+
+		if (n == 0 || i < n) {
+			count_overrun(seq + done, count - done);
+			break;
+		}
+	}
+	k_sem_give(&data_ready_sem);
+}
 
+int eeg_set_channel_mask(uint8_t mask)
+{
+	int err, stream_err;
+	uint32_t start_cyc = k_cycle_get_32();
+
+	if (mask == 0) {
+		return -EINVAL;
+	}
+
+	k_mutex_lock(&layout_lock, K_FOREVER);
+
+	if (IS_ENABLED(CONFIG_TI_ADS1299_DPPI_STREAM)) {
+		ti_ads1299_stream_stop(ads1299_spi_dev);
+	}
+
+	// 이전 세대로 쌓인 프레임은 처리 스레드가 폐기
+	err = ti_ads1299_set_channels(ads1299_spi_dev, mask, EEG_CHNSET);
+	if (err == 0) {
+		layout_update(mask);
+		gains_update();
+	} else {
+		LOG_ERR("Error setting channel mask 0x%02x, err: %d", mask, err);
+	}
+
+	if (IS_ENABLED(CONFIG_TI_ADS1299_DPPI_STREAM)) {
+		uint32_t stopped_us =
+			k_cyc_to_us_ceil32(k_cycle_get_32() - start_cyc);
+
+		count_skipped(DIV_ROUND_UP(
+			(uint64_t)stopped_us *
+				ti_ads1299_get_data_rate(ads1299_spi_dev),
+			USEC_PER_SEC));
+
+		stream_err = ti_ads1299_stream_start(ads1299_spi_dev,
+						     layout.frame_size,
+						     eeg_stream_handler, NULL);
+		if (err == 0) {
+			err = stream_err;
+		}
+	}
+
+	k_mutex_unlock(&layout_lock);
+
+	return err;
+}
+
+int eeg_apply_registers(void)
+{
+	int skipped;
+
+	// 폴링 모드의 프레임 읽기와 SPI 전송이 섞이지 않도록 잠금
+	k_mutex_lock(&layout_lock, K_FOREVER);
+	skipped = ti_ads1299_apply(ads1299_spi_dev);
+	// 게인이 바뀌었으면 새 세대의 프레임부터 새 배율로 디코딩
+	gains_update();
+	// 재설정 중에 걸린 DRDY는 버림
+	k_sem_reset(&drdy_sem);
+	k_mutex_unlock(&layout_lock);
+
+	if (skipped < 0) {
+		LOG_ERR("Error applying ADS1299 registers, err: %d", skipped);
+	} else {
+		count_skipped(skipped);
+		LOG_INF("ADS1299 registers applied, %d samples skipped",
+			skipped);
+	}
+
+	return skipped;
+}
+
+void eeg_get_stats(struct eeg_stats *stats)
+{
+	stats->drdy = atomic_get(&counters.drdy);
+	stats->reads = atomic_get(&counters.reads);
+	stats->read_errors = atomic_get(&counters.read_errors);
+	stats->overruns = atomic_get(&counters.overruns);
+	stats->processed = atomic_get(&counters.processed);
+	stats->processing_drops = atomic_get(&counters.processing_drops);
+	stats->gaps = atomic_get(&counters.gaps);
+	stats->transport_drops = atomic_get(&counters.transport_drops);
+}
+
+uint32_t eeg_latency_us(void)
+{
+	static uint32_t latency_us;
+
+	// 엔진과 블록 크기는 빌드 시 정해지므로 한 번만 계산
+	if (latency_us == 0) {
+		// 데이터 속도로 세는 구간: 블록 대기와 데시메이션 필터
+		float32_t samples = (EEG_BLOCK_FRAMES - 1) +
+				    decimate_group_delay();
+
+#ifdef CONFIG_TI_ADS1299_DPPI_STREAM
+		// DMA 블록의 첫 프레임은 블록이 찰 때까지 CPU에 보이지 않음
+		samples += CONFIG_TI_ADS1299_STREAM_FRAMES - 1;
+#endif
+		latency_us = (uint32_t)(
+			samples * USEC_PER_SEC /
+				CONFIG_TI_ADS1299_DATA_RATE_SPS +
+			filterGroupDelay(FILTER_DELAY_FREQ) *
+				USEC_PER_SEC / EEG_OUTPUT_RATE);
+	}
+
+	return latency_us;
+}
+
+void eeg_count_transport_drops(uint32_t frames)
+{
+	atomic_add(&counters.transport_drops, frames);
+}
+
+// generation 세대의 프레임을 읽은 레이아웃으로 전환. 그 뒤에 레이아웃이 다시
+// 바뀌었으면 그 프레임들은 이미 낡았으므로 false
+static bool layout_adopt(uint32_t generation)
+{
+	uint8_t mask = proc_layout.channel_mask;
+	int err;
+
+	k_mutex_lock(&layout_lock, K_FOREVER);
+	if (layout.generation == generation) {
+		proc_layout = layout;
+	}
+	k_mutex_unlock(&layout_lock);
+
+	if (proc_layout.generation != generation) {
+		return false;
+	}
+
+	err = unpack_set_gains(proc_layout.chnset, proc_layout.num_channels);
+	if (err) {
+		LOG_ERR("Error setting channel gains, err: %d", err);
+	}
+	// 게인만 바뀐 경우에는 필터 상태와 시퀀스 추적을 이어감
+	if (proc_layout.channel_mask != mask) {
+		decimate_reset(proc_layout.num_channels);
+		setFilterChannels(proc_layout.num_channels);
+		epoch_reset(proc_layout.num_channels);
+		quality_reset(proc_layout.num_channels);
+		atomic_set(&seq_resync, 1);
+	}
+
+	return true;
+}
+
+// frames 앞쪽에서 첫 프레임과 같은 세대인 프레임 수
+static uint32_t generation_span(struct eeg_frame *const *frames, uint32_t n)
+{
+	uint32_t i = 1;
+
+	while (i < n && frames[i]->hdr.generation ==
+				frames[0]->hdr.generation) {
+		i++;
+	}
+
+	return i;
+}
+
+static void data_processing_thread(void *arg1, void *arg2, void *arg3)
+{
 	while (1) {
 		k_sem_take(&data_ready_sem, K_FOREVER);
 
-		while (ring_buf_get(&ring_buf, data, DATA_SIZE) == DATA_SIZE) {
-			process_and_print_data(data, DATA_SIZE);
+		// 블록 하나가 모일 때마다 처리 (큐 끝이나 레이아웃 변경에서
+		// 나뉘면 짧은 블록 둘)
+		while (frame_queue_count(&eeg_queue) >= EEG_BLOCK_FRAMES) {
+			uint32_t n;
+			struct eeg_frame **frames =
+				frame_queue_peek(&eeg_queue, &n);
+			uint32_t generation = frames[0]->hdr.generation;
+
+			n = generation_span(frames, MIN(n, EEG_BLOCK_FRAMES));
+			if (generation == proc_layout.generation ||
+			    layout_adopt(generation)) {
+				process_block(frames, n);
+			} else {
+				atomic_add(&counters.processing_drops, n);
+			}
+			for (uint32_t i = 0; i < n; i++) {
+				eeg_frame_unref(frames[i]);
+			}
+			frame_queue_release(&eeg_queue, n);
 		}
 	}
 }
@@ -148,29 +572,74 @@ static void eeg_thread(void)
 		return;
 	}
 
-	ads1299_init();
-	ring_buf_init(&ring_buf, sizeof(ring_buffer_data), ring_buffer_data);
+	// 필터 상태는 처리 스레드가 첫 프레임에서 이 레이아웃으로 초기화
+	k_mutex_lock(&layout_lock, K_FOREVER);
+	layout_update(ti_ads1299_get_channels(ads1299_spi_dev));
+	gains_update();
+	k_mutex_unlock(&layout_lock);
+	LOG_INF("Active channels 0x%02x x %d devices, %zu bytes per frame",
+		layout.channel_mask, EEG_NUM_DEVICES, layout.frame_size);
+
+	// DPPI 스트림 모드에서는 드라이버가 DRDY 핀을 직접 사용
+	if (!IS_ENABLED(CONFIG_TI_ADS1299_DPPI_STREAM)) {
+		ads1299_init();
+	}
 
 #define START 0x08
 #define RDATAC 0x10
 	ti_ads1299_command(ads1299_spi_dev, START);
 	ti_ads1299_command(ads1299_spi_dev, RDATAC);
 
-	uint8_t data[DATA_SIZE];
+	if (IS_ENABLED(CONFIG_TI_ADS1299_DPPI_STREAM)) {
+		// DRDY -> SPIM 전송은 하드웨어가 처리하므로 이 스레드는 종료
+		err = ti_ads1299_stream_start(ads1299_spi_dev,
+					      layout.frame_size,
+					      eeg_stream_handler, NULL);
+		if (err != 0) {
+			LOG_ERR("Error starting ADS1299 stream, err: %d", err);
+		}
+		return;
+	}
 
 	while (1) {
+		uint32_t n;
+		struct eeg_frame **slot;
+
 		k_sem_take(&drdy_sem, K_FOREVER);
-		if (ti_ads1299_read_data(ads1299_spi_dev, data, sizeof(data)) ==
-		    0) {
-			uint32_t bytes_written =
-				ring_buf_put(&ring_buf, data, DATA_SIZE);
-			if (bytes_written != DATA_SIZE) {
-				LOG_WRN("Ring buffer full, data lost");
+		k_mutex_lock(&layout_lock, K_FOREVER);
+		// RDATAC는 최신 변환 결과를 내보내므로 마지막 DRDY와 짝이 맞음
+		uint32_t seq = atomic_get(&counters.drdy) - 1;
+		uint32_t timestamp = ti_ads1299_timestamp_get(ads1299_spi_dev);
+		// SPI DMA가 풀 블록에 바로 씀
+		struct eeg_frame *frame = eeg_frame_alloc();
+
+		if (frame == NULL) {
+			count_overrun(seq, 1);
+		} else if (ti_ads1299_read_data(ads1299_spi_dev, frame->data,
+						layout.frame_size) != 0) {
+			eeg_frame_unref(frame);
+			atomic_inc(&counters.read_errors);
+			LOG_ERR("Error reading data from ADS1299");
+		} else if ((slot = frame_queue_claim(&eeg_queue, &n)) == NULL) {
+			eeg_frame_unref(frame);
+			atomic_inc(&counters.reads);
+			count_overrun(seq, 1);
+		} else {
+			frame->hdr.seq = seq;
+			frame->hdr.timestamp = timestamp;
+			frame->hdr.generation = layout.generation;
+			*slot = frame;
+			// 커밋하면 처리 스레드가 참조를 놓을 수 있으므로 먼저 발행
+			if (EEG_DECIMATION == 1) {
+				sample_bus_publish(SAMPLE_TOPIC_RAW,
+						   &frame->ref);
 			}
+			frame_queue_commit(&eeg_queue, 1);
+			atomic_inc(&counters.reads);
+			report_first_sample(0);
 			k_sem_give(&data_ready_sem);
-		} else {
-			LOG_ERR("Error reading data from ADS1299");
 		}
+		k_mutex_unlock(&layout_lock);
 	}
 }
 
@@ -184,3 +653,32 @@ K_THREAD_DEFINE(eeg_thread_id, EEG_STACKSIZE, eeg_thread, NULL, NULL, NULL,
 K_THREAD_DEFINE(processing_thread_id, PROCESSING_STACKSIZE,
 		data_processing_thread, NULL, NULL, NULL, PROCESSING_PRIORITY,
 		0, 0);
+
+#ifdef CONFIG_SHELL
+static int cmd_eeg_stats(const struct shell *sh, size_t argc, char **argv)
+{
+	struct eeg_stats stats;
+
+	eeg_get_stats(&stats);
+	shell_print(sh, "drdy:             %u", stats.drdy);
+	shell_print(sh, "reads:            %u", stats.reads);
+	shell_print(sh, "read errors:      %u", stats.read_errors);
+	shell_print(sh, "overruns:         %u", stats.overruns);
+	shell_print(sh, "processed:        %u", stats.processed);
+	shell_print(sh, "processing drops: %u", stats.processing_drops);
+	shell_print(sh, "gaps:             %u", stats.gaps);
+	shell_print(sh, "transport drops:  %u", stats.transport_drops);
+	shell_print(sh, "free frames:      %u/%u", eeg_frame_pool_free(),
+		    EEG_POOL_BLOCKS);
+	shell_print(sh, "latency:          %u us (%s filter)", eeg_latency_us(),
+		    filterEngine()->name);
+
+	return 0;
+}
+
+SHELL_STATIC_SUBCMD_SET_CREATE(
+	sub_eeg,
+	SHELL_CMD(stats, NULL, "Acquisition pipeline counters", cmd_eeg_stats),
+	SHELL_SUBCMD_SET_END);
+SHELL_CMD_REGISTER(eeg, &sub_eeg, "EEG acquisition", NULL);
+#endif
@@ -0,0 +1,257 @@
+#ifndef __APP_EEG_H__
+#define __APP_EEG_H__
+
+#include <math.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <arm_math.h>
+#include <zephyr/devicetree.h>
+#include <zephyr/sys/util.h>
+#include <zephyr/toolchain.h>
+
+/* ADS1299s daisy-chained behind the ads1299 node, read as one wide frame */
+#define EEG_NUM_DEVICES DT_PROP(DT_NODELABEL(ads1299), daisy_chain_length)
+
+/*
+ * ADS1299 frame: per chip, a 24-bit status word followed by 8 24-bit
+ * big-endian samples. Daisy-chained chips follow each other in one burst.
+ */
+#define EEG_CHANNELS_PER_DEVICE 8
+#define EEG_STATUS_SIZE 3
+#define EEG_SAMPLE_SIZE 3
+#define EEG_DEVICE_FRAME_SIZE \
+	(EEG_STATUS_SIZE + EEG_CHANNELS_PER_DEVICE * EEG_SAMPLE_SIZE)
+#define EEG_MAX_CHANNELS (EEG_NUM_DEVICES * EEG_CHANNELS_PER_DEVICE)
+#define EEG_MAX_FRAME_SIZE (EEG_NUM_DEVICES * EEG_DEVICE_FRAME_SIZE)
+
+/*
+ * Rate every stage after the SPI decode runs at. Below the ADS1299 data rate
+ * frames are low-pass filtered and decimated by EEG_DECIMATION first.
+ */
+#define EEG_OUTPUT_RATE CONFIG_APP_EEG_OUTPUT_RATE_SPS
+#define EEG_DECIMATION (CONFIG_TI_ADS1299_DATA_RATE_SPS / EEG_OUTPUT_RATE)
+
+/*
+ * Frames processed together: each filter stage runs once per channel over a
+ * block of this many samples. Bounded by CONFIG_APP_EEG_BLOCK_LATENCY_MS at
+ * the configured data rate.
+ */
+#define EEG_BLOCK_MAX 32
+#define EEG_BLOCK_FRAMES                                                \
+	CLAMP(CONFIG_TI_ADS1299_DATA_RATE_SPS *                         \
+		      CONFIG_APP_EEG_BLOCK_LATENCY_MS / 1000,           \
+	      1, EEG_BLOCK_MAX)
+
+/*
+ * A 24-bit code spans +-VREF / GAIN volts. EEG_GAIN is the PGA setting
+ * channels start with and the scale of the helpers below; the frame decoder
+ * (unpack.h) scales each channel by its live CHnSET gain instead.
+ */
+#define EEG_VREF 4.5f
+#define EEG_GAIN 24
+#define EEG_LSB_VOLTS (EEG_VREF / EEG_GAIN / (1 << 23))
+
+/*
+ * With CONFIG_APP_EEG_Q31 codes are shifted into q31 leaving two guard bits
+ * for filter overshoot, q31 full scale is then 4 * VREF / GAIN volts.
+ */
+#define EEG_Q31_SHIFT 6
+
+/* Sample type from decode through the filters to the filtered consumers */
+#ifdef CONFIG_APP_EEG_Q31
+typedef q31_t eeg_sample_t;
+#else
+typedef float32_t eeg_sample_t;
+#endif
+
+/* Sign-extended 24-bit big-endian code */
+static inline int32_t eeg_decode_code(const uint8_t *sample)
+{
+	return (int32_t)(((uint32_t)sample[0] << 24) |
+			 ((uint32_t)sample[1] << 16) |
+			 ((uint32_t)sample[2] << 8)) >> 8;
+}
+
+static inline q31_t eeg_code_to_q31(int32_t code)
+{
+	return (q31_t)(code * (1 << EEG_Q31_SHIFT));
+}
+
+static inline float32_t eeg_q31_to_volts(q31_t sample)
+{
+	return (float32_t)sample * (EEG_LSB_VOLTS / (1 << EEG_Q31_SHIFT));
+}
+
+static inline eeg_sample_t eeg_decode_sample(const uint8_t *sample)
+{
+#ifdef CONFIG_APP_EEG_Q31
+	return eeg_code_to_q31(eeg_decode_code(sample));
+#else
+	return (float32_t)eeg_decode_code(sample) * EEG_LSB_VOLTS;
+#endif
+}
+
+/* Convert to volts at the edge, for consumers that want physical units */
+static inline float32_t eeg_sample_to_volts(eeg_sample_t sample)
+{
+#ifdef CONFIG_APP_EEG_Q31
+	return eeg_q31_to_volts(sample);
+#else
+	return sample;
+#endif
+}
+
+/** @brief Header queued in front of every frame. */
+struct eeg_frame_hdr {
+	/* DRDY period the frame was converted in, counted from boot. A jump
+	 * of more than one between consecutive frames is a gap; decimated
+	 * frames on the sample bus step by EEG_DECIMATION.
+	 */
+	uint32_t seq;
+	/* Hardware time of the DRDY edge in TI_ADS1299_TIMESTAMP_HZ ticks,
+	 * 0 without CONFIG_TI_ADS1299_TIMESTAMP
+	 */
+	uint32_t timestamp;
+	/* Generation of the eeg_layout the frame was read with */
+	uint32_t generation;
+};
+
+/**
+ * @brief Planar block of consecutive frames, passed from the frame decode
+ * through the decimator and the filters to the sample bus consumers.
+ *
+ * samples[ch][i] is active channel ch of the i-th frame, so every channel is
+ * one contiguous, word-aligned row the CMSIS-DSP vector kernels take as is.
+ * After the decimator consecutive frames are EEG_DECIMATION DRDY periods
+ * apart. unpack_encode() converts a frame back to the interleaved wire format
+ * at the transport.
+ */
+struct eeg_block {
+	/* Sequence number and DRDY timestamp of the first frame, see
+	 * eeg_frame_hdr
+	 */
+	uint32_t seq;
+	uint32_t timestamp;
+	/* Frames in the block, at most EEG_BLOCK_FRAMES */
+	uint16_t count;
+	uint8_t num_channels;
+	eeg_sample_t samples[EEG_MAX_CHANNELS][EEG_BLOCK_FRAMES];
+};
+
+/**
+ * @brief Acquisition layout derived from the active channel mask.
+ *
+ * Only the bytes up to the highest active channel are clocked out of the
+ * ADS1299, and only active channels are decoded, filtered and transmitted.
+ */
+struct eeg_layout {
+	/* Bumped on every change, frames carry the one they were read with */
+	uint32_t generation;
+	/* Bit n set when channel n + 1 is powered, on every chip of the chain */
+	uint8_t channel_mask;
+	/* Number of active channels across the chain */
+	uint8_t num_channels;
+	/* Frame offset of each active channel's sample, in channel order */
+	uint16_t offset[EEG_MAX_CHANNELS];
+	/* CHnSET of each active channel, for its PGA gain */
+	uint8_t chnset[EEG_MAX_CHANNELS];
+	/* Bytes read per DRDY, status word included */
+	size_t frame_size;
+	/* Bytes one sample of all active channels takes on the radio */
+	size_t packet_size;
+	/* Samples batched into one notification at the current data rate */
+	size_t frames_per_packet;
+};
+
+/* ATT payload of one BLE notification at the 247-byte MTU */
+#define EEG_NOTIFY_MAX_LEN 244
+
+/**
+ * @brief Header in front of the samples of every BLE notification, sent
+ * little-endian.
+ */
+struct eeg_packet_hdr {
+	/* Sequence number of the first frame, see eeg_frame_hdr */
+	uint32_t seq;
+	/* Time the first frame waited in the transport before the notification */
+	uint32_t transport_us;
+	/* On-device processing latency, see eeg_latency_us() */
+	uint32_t pipeline_us;
+} __packed;
+
+/**
+ * @brief Copy the current acquisition layout.
+ *
+ * Frames queued before a change still carry the previous generation, see
+ * eeg_frame_hdr.
+ */
+void eeg_get_layout(struct eeg_layout *layout);
+
+/**
+ * @brief Change the set of active channels while acquisition runs.
+ *
+ * The mask is per chip; in a daisy chain every chip powers the same channels.
+ *
+ * Reconfigures the ADS1299 and publishes a new layout generation. The
+ * processing thread re-derives the frame decoder and the filter state when
+ * the first frame of it arrives and discards frames of older layouts still
+ * queued.
+ *
+ * @return 0 on success, -EINVAL for an empty mask, or a driver error.
+ */
+int eeg_set_channel_mask(uint8_t mask);
+
+/**
+ * @brief Write registers staged with ti_ads1299_stage_reg() while
+ * acquisition runs, e.g. to change gain or input mux mid-session.
+ *
+ * @return Number of samples skipped during the reconfiguration window, or a
+ *         negative errno from ti_ads1299_apply().
+ */
+int eeg_apply_registers(void);
+
+/**
+ * @brief Acquisition pipeline counters, monotonic since boot.
+ *
+ * A recording is gap-free when @c reads kept up with @c drdy and
+ * @c overruns, @c processing_drops, @c gaps and @c transport_drops stayed
+ * at zero.
+ */
+struct eeg_stats {
+	/*
+	 * DRDY periods, including ones skipped while reconfiguring. Counted
+	 * in hardware while streaming, so unread conversions keep reads below
+	 */
+	uint32_t drdy;
+	/* Frames read from the ADS1299 */
+	uint32_t reads;
+	/* Failed SPI reads */
+	uint32_t read_errors;
+	/* Frames lost because the processing queue was full */
+	uint32_t overruns;
+	/* Frames processed */
+	uint32_t processed;
+	/* Queued frames discarded without processing, e.g. on reconfiguration */
+	uint32_t processing_drops;
+	/* Sequence numbers missing at the processing input */
+	uint32_t gaps;
+	/* Frames the transport failed to send */
+	uint32_t transport_drops;
+};
+
+/**
+ * @brief Latency of the filtered stream behind the DRDY edge of a frame.
+ *
+ * The worst-case wait for a DMA block and a processing block to fill, plus
+ * the group delay of the decimator, the selected filter engine and the notch at
+ * FILTER_DELAY_FREQ. Every filtered block on the sample bus is tagged with it.
+ */
+uint32_t eeg_latency_us(void);
+
+/** @brief Snapshot of the pipeline counters. */
+void eeg_get_stats(struct eeg_stats *stats);
+
+/** @brief Account @p frames the transport could not deliver. */
+void eeg_count_transport_drops(uint32_t frames);
+
+#endif // __APP_EEG_H__
@@ -0,0 +1,140 @@
+#include "bandpower.h"
+#include "eeg_features.h"
+#include "frame_pool.h"
+#include "sample_bus.h"
+
+#include <math.h>
+#include <stddef.h>
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/sys/byteorder.h>
+
+#ifdef CONFIG_APP_EEG_FEATURES
+LOG_MODULE_REGISTER(FEATURES, CONFIG_APP_LOG_LEVEL);
+
+BUILD_ASSERT(offsetof(struct eeg_features, ref) == 0,
+	     "pool blocks are freed through their sample_ref");
+BUILD_ASSERT(FEATURES_HOP > 0, "segments must not overlap completely");
+
+// 구독자에게 전달 중인 특징 프레임
+#define FEATURES_BLOCKS 2
+K_MEM_SLAB_DEFINE_STATIC(features_slab, sizeof(struct eeg_features),
+			 FEATURES_BLOCKS, sizeof(uint32_t));
+
+/*
+ * Filtered blocks to analyse. A block the bus drops for us shows up as a
+ * sequence gap and restarts the analysis window.
+ */
+SAMPLE_SUB_DEFINE(features_sub, BIT(SAMPLE_TOPIC_FILTERED),
+		  EEG_FILTERED_SUB_DEPTH, SAMPLE_DROP_OLDEST);
+
+// 다음 세그먼트까지 남은 샘플 수
+static size_t until_segment;
+// 다음 블록의 첫 시퀀스 번호
+static uint32_t expected_seq;
+static uint8_t channels;
+
+static void features_reset(const struct eeg_block *block)
+{
+	bandpower_reset(block->num_channels);
+	channels = block->num_channels;
+	until_segment = FEATURES_SEGMENT_LEN;
+}
+
+// 세그먼트를 분석하고 구독자가 있으면 특징 프레임으로 발행
+static void features_publish(uint32_t seq)
+{
+	// 발행하지 않아도 세그먼트 평균이 이어지도록 계산은 항상 함
+	static struct eeg_features unpublished;
+	struct eeg_features *features = NULL;
+
+	if (sample_bus_has_subscribers(SAMPLE_TOPIC_FEATURES) &&
+	    k_mem_slab_alloc(&features_slab, (void **)&features, K_NO_WAIT) ==
+		    0) {
+		sample_ref_init(&features->ref, &features_slab);
+	} else {
+		features = NULL;
+	}
+
+	bandpower_update(features != NULL ? features : &unpublished);
+
+	if (features != NULL) {
+		features->seq = seq;
+		sample_bus_publish(SAMPLE_TOPIC_FEATURES, &features->ref);
+		sample_ref_put(&features->ref);
+	}
+}
+
+static void features_process(const struct eeg_block *block)
+{
+	size_t done = 0;
+
+	// 빠진 프레임이 있거나 채널이 바뀌면 창을 처음부터 다시 채움
+	if (block->seq != expected_seq || block->num_channels != channels) {
+		features_reset(block);
+	}
+	expected_seq = block->seq + block->count * EEG_DECIMATION;
+
+	while (done < block->count) {
+		size_t n = MIN(block->count - done, until_segment);
+
+		bandpower_push(block, done, n);
+		done += n;
+		until_segment -= n;
+		if (until_segment == 0) {
+			until_segment = FEATURES_HOP;
+			features_publish(block->seq +
+					 (done - 1) * EEG_DECIMATION);
+		}
+	}
+}
+
+void eeg_features_pack(const struct eeg_features *features, int ch,
+		       uint8_t *dst)
+{
+	for (int b = 0; b < EEG_BAND_COUNT; b++) {
+		// 1 uV^2 기준 0.01 dB 단위, 전력이 0이면 int16 최솟값
+		float32_t uv2 = features->band_power[ch][b] * 1e12f;
+		int32_t cdb = uv2 > 0.0f ? lrintf(1000.0f * log10f(uv2)) :
+					   INT16_MIN;
+
+		sys_put_le16(CLAMP(cdb, INT16_MIN, INT16_MAX),
+			     &dst[offsetof(struct eeg_band_record, power_cdb) +
+				  b * sizeof(int16_t)]);
+		sys_put_le16(lrintf(features->relative_power[ch][b] *
+				    UINT16_MAX),
+			     &dst[offsetof(struct eeg_band_record, relative) +
+				  b * sizeof(uint16_t)]);
+	}
+}
+
+static void features_thread(void)
+{
+	struct sample_msg msg;
+	int err = bandpower_init();
+
+	if (err) {
+		LOG_ERR("Error initializing band powers, err: %d", err);
+		return;
+	}
+	LOG_INF("Band powers every %u ms over %u ms segments",
+		FEATURES_HOP * MSEC_PER_SEC / EEG_OUTPUT_RATE,
+		FEATURES_SEGMENT_LEN * MSEC_PER_SEC / EEG_OUTPUT_RATE);
+
+	sample_bus_subscribe(&features_sub);
+
+	while (1) {
+		const struct eeg_filtered *filtered;
+
+		sample_sub_get(&features_sub, &msg, K_FOREVER);
+		filtered = CONTAINER_OF(msg.obj, struct eeg_filtered, ref);
+		features_process(&filtered->block);
+		sample_ref_put(msg.obj);
+	}
+}
+
+#define FEATURES_STACKSIZE 2048
+#define FEATURES_PRIORITY 4
+K_THREAD_DEFINE(features_thread_id, FEATURES_STACKSIZE, features_thread, NULL,
+		NULL, NULL, FEATURES_PRIORITY, 0, 0);
+#endif
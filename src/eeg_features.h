@@ -0,0 +1,66 @@
+#ifndef __APP_EEG_FEATURES_H__
+#define __APP_EEG_FEATURES_H__
+
+#include "eeg.h"
+#include "sample_bus.h"
+
+#include <stdint.h>
+#include <zephyr/toolchain.h>
+
+/*
+ * Welch analysis of the filtered stream at EEG_OUTPUT_RATE: segments of
+ * FEATURES_SEGMENT_LEN samples start every FEATURES_HOP samples, and the band
+ * powers of the last FEATURES_SEGMENTS of them are averaged into one feature
+ * frame per hop.
+ */
+#define FEATURES_SEGMENT_LEN CONFIG_APP_FEATURES_SEGMENT_LEN
+#define FEATURES_HOP                                  \
+	(FEATURES_SEGMENT_LEN *                       \
+	 (100 - CONFIG_APP_FEATURES_OVERLAP_PCT) / 100)
+#define FEATURES_SEGMENTS CONFIG_APP_FEATURES_SEGMENTS
+
+/** @brief EEG frequency bands, edges in bandpower.c. */
+enum eeg_band {
+	EEG_BAND_DELTA,
+	EEG_BAND_THETA,
+	EEG_BAND_ALPHA,
+	EEG_BAND_BETA,
+	EEG_BAND_GAMMA,
+	EEG_BAND_COUNT,
+};
+
+/** @brief Feature frame, published as SAMPLE_TOPIC_FEATURES. */
+struct eeg_features {
+	struct sample_ref ref;
+	/* Sequence number of the newest frame analysed, see eeg_frame_hdr */
+	uint32_t seq;
+	uint8_t num_channels;
+	/* Welch band power of each active channel in V^2 */
+	float32_t band_power[EEG_MAX_CHANNELS][EEG_BAND_COUNT];
+	/* Band power over the sum of the channel's band powers */
+	float32_t relative_power[EEG_MAX_CHANNELS][EEG_BAND_COUNT];
+};
+
+/*
+ * Radio format of a feature frame: an eeg_packet_hdr, an eeg_features_hdr and
+ * eeg_features_hdr::num_channels band records, all little-endian. A frame with
+ * more channels than fit in one notification is split over several with the
+ * same sequence number.
+ */
+struct eeg_features_hdr {
+	uint8_t first_channel;
+	uint8_t num_channels;
+} __packed;
+
+struct eeg_band_record {
+	/* Band power in 0.01 dB relative to 1 uV^2 */
+	int16_t power_cdb[EEG_BAND_COUNT];
+	/* Relative power, 65535 for the whole of the channel's power */
+	uint16_t relative[EEG_BAND_COUNT];
+} __packed;
+
+/** @brief Write channel @p ch of @p features as an eeg_band_record. */
+void eeg_features_pack(const struct eeg_features *features, int ch,
+		       uint8_t *dst);
+
+#endif // __APP_EEG_FEATURES_H__
@@ -0,0 +1,182 @@
+#include "epoch.h"
+
+#include <math.h>
+#include <stddef.h>
+#include <string.h>
+#include <zephyr/kernel.h>
+
+#ifdef CONFIG_APP_EEG_EPOCH
+BUILD_ASSERT(offsetof(struct eeg_epoch, ref) == 0,
+	     "pool blocks are freed through their sample_ref");
+BUILD_ASSERT(EPOCH_LEN >= 3, "an epoch needs second differences");
+
+// 구독자에게 전달 중인 특징 벡터
+#define EPOCH_BLOCKS 2
+K_MEM_SLAB_DEFINE_STATIC(epoch_slab, sizeof(struct eeg_epoch), EPOCH_BLOCKS,
+			 sizeof(uint32_t));
+
+// 채널별 현재 에포크의 누적 합 (d: 1차 차분, dd: 2차 차분)
+struct epoch_sums {
+	float32_t x;
+	float32_t x2;
+	float32_t d;
+	float32_t d2;
+	float32_t dd;
+	float32_t dd2;
+	float32_t abs_d;
+	uint32_t crossings;
+	// 에포크 경계를 넘어 이어지는 직전 샘플과 차분
+	float32_t prev;
+	float32_t prev_d;
+};
+
+static struct epoch_sums sums[EEG_MAX_CHANNELS];
+static int channels;
+// 현재 에포크의 샘플 수와 1차, 2차 차분 수
+static size_t samples;
+static size_t samples_d;
+static size_t samples_dd;
+// 리셋 이후 샘플 수, 2에서 멈춤 (차분을 계산할 수 있는지)
+static uint8_t primed;
+
+void epoch_reset(int num_channels)
+{
+	channels = num_channels;
+	samples = 0;
+	samples_d = 0;
+	samples_dd = 0;
+	primed = 0;
+	memset(sums, 0, sizeof(sums[0]) * num_channels);
+}
+
+static void epoch_accumulate(const struct eeg_block *block, size_t first,
+			     size_t count)
+{
+	for (int ch = 0; ch < channels; ch++) {
+		struct epoch_sums *s = &sums[ch];
+		const eeg_sample_t *in = &block->samples[ch][first];
+		float32_t prev = s->prev;
+		float32_t prev_d = s->prev_d;
+		uint8_t p = primed;
+
+		for (size_t i = 0; i < count; i++) {
+			float32_t x = eeg_sample_to_volts(in[i]);
+
+			s->x += x;
+			s->x2 += x * x;
+			if (p > 0) {
+				float32_t d = x - prev;
+
+				s->d += d;
+				s->d2 += d * d;
+				s->abs_d += fabsf(d);
+				s->crossings += (x < 0.0f) != (prev < 0.0f);
+				if (p > 1) {
+					float32_t dd = d - prev_d;
+
+					s->dd += dd;
+					s->dd2 += dd * dd;
+				} else {
+					p++;
+				}
+				prev_d = d;
+			} else {
+				p++;
+			}
+			prev = x;
+		}
+		s->prev = prev;
+		s->prev_d = prev_d;
+	}
+	// 리셋 직후 첫 샘플에는 1차 차분이, 첫 두 샘플에는 2차 차분이 없음
+	samples += count;
+	samples_d += count - MIN(count, (size_t)(primed == 0));
+	samples_dd += count - MIN(count, (size_t)(2 - primed));
+	primed = MIN(primed + count, 2);
+}
+
+// 평균을 뺀 분산, 누적 오차로 음수가 되면 0
+static float32_t epoch_variance(float32_t sum, float32_t sum_sq, size_t n)
+{
+	float32_t mean;
+
+	if (n == 0) {
+		return 0.0f;
+	}
+	mean = sum / n;
+
+	return MAX(sum_sq / n - mean * mean, 0.0f);
+}
+
+static void epoch_finish(struct eeg_epoch *epoch)
+{
+	const size_t n = samples;
+
+	for (int ch = 0; ch < channels; ch++) {
+		const struct epoch_sums *s = &sums[ch];
+		struct eeg_epoch_channel *out = &epoch->channel[ch];
+		float32_t var = epoch_variance(s->x, s->x2, n);
+		float32_t var_d = epoch_variance(s->d, s->d2, samples_d);
+		float32_t var_dd = epoch_variance(s->dd, s->dd2, samples_dd);
+
+		out->activity = var;
+		out->mobility = var > 0.0f ? sqrtf(var_d / var) : 0.0f;
+		out->complexity =
+			var_d > 0.0f && out->mobility > 0.0f ?
+				sqrtf(var_dd / var_d) / out->mobility :
+				0.0f;
+		out->rms = sqrtf(s->x2 / n);
+		out->line_length = s->abs_d;
+		out->zero_crossing_rate =
+			(float32_t)s->crossings * EEG_OUTPUT_RATE / n;
+	}
+	epoch->num_channels = channels;
+}
+
+// 다음 에포크의 합을 비움, 직전 샘플과 차분은 유지
+static void epoch_clear(void)
+{
+	for (int ch = 0; ch < channels; ch++) {
+		struct epoch_sums *s = &sums[ch];
+
+		memset(s, 0, offsetof(struct epoch_sums, prev));
+	}
+	samples = 0;
+	samples_d = 0;
+	samples_dd = 0;
+}
+
+// 구독자가 있으면 끝난 에포크를 발행
+static void epoch_publish(uint32_t seq)
+{
+	struct eeg_epoch *epoch;
+
+	if (!sample_bus_has_subscribers(SAMPLE_TOPIC_EPOCH) ||
+	    k_mem_slab_alloc(&epoch_slab, (void **)&epoch, K_NO_WAIT) != 0) {
+		return;
+	}
+	sample_ref_init(&epoch->ref, &epoch_slab);
+
+	epoch->seq = seq;
+	epoch_finish(epoch);
+	sample_bus_publish(SAMPLE_TOPIC_EPOCH, &epoch->ref);
+	sample_ref_put(&epoch->ref);
+}
+
+void epoch_push(const struct eeg_block *block)
+{
+	size_t done = 0;
+
+	while (done < block->count) {
+		size_t n = MIN(block->count - done, EPOCH_LEN - samples);
+
+		epoch_accumulate(block, done, n);
+		done += n;
+		if (samples == EPOCH_LEN) {
+			epoch_publish(block->seq +
+				      (done - 1) * EEG_DECIMATION);
+			epoch_clear();
+		}
+	}
+}
+#endif
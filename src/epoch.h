@@ -0,0 +1,66 @@
+#ifndef __APP_EPOCH_H__
+#define __APP_EPOCH_H__
+
+#include "eeg.h"
+#include "sample_bus.h"
+
+#include <stddef.h>
+#include <stdint.h>
+#include <zephyr/toolchain.h>
+
+/*
+ * Time-domain features of the filtered stream over back-to-back epochs of
+ * EPOCH_LEN samples at EEG_OUTPUT_RATE, from running sums updated once per
+ * sample by the processing thread.
+ */
+#define EPOCH_LEN (EEG_OUTPUT_RATE * CONFIG_APP_EEG_EPOCH_MS / MSEC_PER_SEC)
+
+/** @brief Features of one channel over one epoch. */
+struct eeg_epoch_channel {
+	/* Hjorth activity, the variance in V^2 */
+	float32_t activity;
+	/* Hjorth mobility, sqrt(var(x') / var(x)) per output sample */
+	float32_t mobility;
+	/* Hjorth complexity, mobility of x' over mobility of x */
+	float32_t complexity;
+	/* Root mean square in V */
+	float32_t rms;
+	/* Sum of |x[n] - x[n - 1]| over the epoch in V */
+	float32_t line_length;
+	/* Sign changes per second */
+	float32_t zero_crossing_rate;
+};
+
+/** @brief Epoch feature vector, published as SAMPLE_TOPIC_EPOCH. */
+struct eeg_epoch {
+	struct sample_ref ref;
+	/* Sequence number of the last frame of the epoch, see eeg_frame_hdr */
+	uint32_t seq;
+	uint8_t num_channels;
+	struct eeg_epoch_channel channel[EEG_MAX_CHANNELS];
+};
+
+#ifdef CONFIG_APP_EEG_EPOCH
+/** @brief Start a new epoch of num_channels channels. */
+void epoch_reset(int num_channels);
+
+/**
+ * @brief Add a filtered block to the running sums.
+ *
+ * O(1) per sample and channel. Publishes one eeg_epoch for every epoch the
+ * block completes, when SAMPLE_TOPIC_EPOCH has subscribers.
+ */
+void epoch_push(const struct eeg_block *block);
+#else
+static inline void epoch_reset(int num_channels)
+{
+	ARG_UNUSED(num_channels);
+}
+
+static inline void epoch_push(const struct eeg_block *block)
+{
+	ARG_UNUSED(block);
+}
+#endif
+
+#endif // __APP_EPOCH_H__
@@ -1,46 +1,40 @@
 #include "filter.h"
+#include "eeg.h"
+#include "notch.h"
 
-#define BLOCK_SIZE 1
-#define HIGHPASS_FILTER_ORDER 401 // Reduced order for each filter
-#define LOWPASS_FILTER_ORDER 401 // Reduced order for each filter
-#define HIGHPASS_FILTER_LEN (HIGHPASS_FILTER_ORDER + 1)
-#define LOWPASS_FILTER_LEN (LOWPASS_FILTER_ORDER + 1)
-#define SAMPLING_RATE 250
-#define HIGH_CUTOFF 2.0f
-#define LOW_CUTOFF 40.0f
+#include <math.h>
+#include <string.h>
 
-#define ADS1299_CHANNELS 2
+#define BLOCK_SIZE EEG_BLOCK_FRAMES
+#define SAMPLING_RATE FILTER_SAMPLING_RATE
 
-// FIR filter instances
-arm_fir_instance_f32 hp_instance;
-arm_fir_instance_f32 lp_instance;
+// Blackman-windowed sinc tap n of a lowpass at fc cycles/sample, unnormalized
+static float32_t windowed_sinc(int n, uint16_t order, float32_t fc)
+{
+	float32_t h;
 
-// Filter coefficients and state buffers
-static float32_t hp_coeffs[HIGHPASS_FILTER_LEN];
-static float32_t lp_coeffs[LOWPASS_FILTER_LEN];
-static float32_t hp_state[ADS1299_CHANNELS]
-			 [BLOCK_SIZE + HIGHPASS_FILTER_LEN - 1];
-static float32_t lp_state[ADS1299_CHANNELS][BLOCK_SIZE + LOWPASS_FILTER_LEN - 1];
+	if (n == order / 2) {
+		h = 2.0f * fc;
+	} else {
+		float32_t nm = (float32_t)n - (float32_t)order / 2.0f;
+		h = arm_sin_f32(2.0f * PI * fc * nm) / (PI * nm);
+	}
 
-void calculate_hp_coeffs(float32_t *coeffs, uint16_t order, float32_t cutoff,
+	// Apply Blackman window
+	return h * (0.42f -
+		    0.5f * arm_cos_f32(2.0f * PI * (float32_t)n /
+				       (float32_t)order) +
+		    0.08f * arm_cos_f32(4.0f * PI * (float32_t)n /
+					(float32_t)order));
+}
+
+void calculate_lp_coeffs(float32_t *coeffs, uint16_t order, float32_t cutoff,
 			 float32_t sampling_rate)
 {
 	float32_t fc = cutoff / sampling_rate;
 
 	for (int n = 0; n <= order; n++) {
-		if (n == order / 2) {
-			coeffs[n] = 1.0f - 2.0f * fc;
-		} else {
-			float32_t nm = (float32_t)n - (float32_t)order / 2.0f;
-			coeffs[n] =
-				-arm_sin_f32(2.0f * PI * fc * nm) / (PI * nm);
-		}
-		// Apply Blackman window
-		coeffs[n] *= (0.42f -
-			      0.5f * arm_cos_f32(2.0f * PI * (float32_t)n /
-						 (float32_t)order) +
-			      0.08f * arm_cos_f32(4.0f * PI * (float32_t)n /
-						  (float32_t)order));
+		coeffs[n] = windowed_sinc(n, order, fc);
 	}
 
 	// Normalize coefficients
@@ -53,69 +47,398 @@ void calculate_hp_coeffs(float32_t *coeffs, uint16_t order, float32_t cutoff,
 	}
 }
 
-void calculate_lp_coeffs(float32_t *coeffs, uint16_t order, float32_t cutoff,
+void calculate_hp_coeffs(float32_t *coeffs, uint16_t order, float32_t cutoff,
 			 float32_t sampling_rate)
 {
-	float32_t fc = cutoff / sampling_rate;
-
+	// Spectral inversion of a unity-gain lowpass: delta - lowpass
+	calculate_lp_coeffs(coeffs, order, cutoff, sampling_rate);
 	for (int n = 0; n <= order; n++) {
-		if (n == order / 2) {
-			coeffs[n] = 2.0f * fc;
-		} else {
-			float32_t nm = (float32_t)n - (float32_t)order / 2.0f;
-			coeffs[n] =
-				arm_sin_f32(2.0f * PI * fc * nm) / (PI * nm);
-		}
-		// Apply Blackman window
-		coeffs[n] *= (0.42f -
-			      0.5f * arm_cos_f32(2.0f * PI * (float32_t)n /
-						 (float32_t)order) +
-			      0.08f * arm_cos_f32(4.0f * PI * (float32_t)n /
-						  (float32_t)order));
+		coeffs[n] = -coeffs[n];
 	}
+	coeffs[order / 2] += 1.0f;
+}
+
+void calculate_bp_coeffs(float32_t *coeffs, uint16_t order,
+			 float32_t low_cutoff, float32_t high_cutoff,
+			 float32_t sampling_rate)
+{
+	// Difference of two unity-gain lowpasses, without a scratch table
+	float32_t fc_low = low_cutoff / sampling_rate;
+	float32_t fc_high = high_cutoff / sampling_rate;
+	float32_t sum_low = 0.0f, sum_high = 0.0f;
 
-	// Normalize coefficients
-	float32_t sum = 0.0f;
 	for (int n = 0; n <= order; n++) {
-		sum += coeffs[n];
+		sum_low += windowed_sinc(n, order, fc_low);
+		sum_high += windowed_sinc(n, order, fc_high);
 	}
 	for (int n = 0; n <= order; n++) {
-		coeffs[n] /= sum;
+		coeffs[n] = windowed_sinc(n, order, fc_high) / sum_high -
+			    windowed_sinc(n, order, fc_low) / sum_low;
 	}
 }
 
-int initFilters(void)
+// Product of |B(e^jw) / A(e^jw)| over the stages
+float32_t biquad_magnitude(const float32_t *coeffs, int stages, float32_t freq)
 {
-	// Calculate highpass filter coefficients
-	calculate_hp_coeffs(hp_coeffs, HIGHPASS_FILTER_ORDER, HIGH_CUTOFF,
-			    SAMPLING_RATE);
+	double w = 2.0 * PI * freq / SAMPLING_RATE;
+	double c1 = cos(w), s1 = sin(w), c2 = cos(2 * w), s2 = sin(2 * w);
+	double mag = 1.0;
+
+	for (int k = 0; k < stages; k++) {
+		const float32_t *c = &coeffs[5 * k];
+		double br = c[0] + c[1] * c1 + c[2] * c2;
+		double bi = -c[1] * s1 - c[2] * s2;
+		double ar = 1.0 - c[3] * c1 - c[4] * c2;
+		double ai = c[3] * s1 + c[4] * s2;
+
+		mag *= sqrt((br * br + bi * bi) / (ar * ar + ai * ai));
+	}
+
+	return mag;
+}
+
+// Group delay of sum(c[k] * z^-k): Re(sum(k c[k] e^-jwk) / sum(c[k] e^-jwk))
+static double poly_group_delay(const double *c, int n, double w)
+{
+	double re = 0.0, im = 0.0, dre = 0.0, dim = 0.0;
+
+	for (int k = 0; k < n; k++) {
+		double ck = c[k] * cos(w * k), sk = c[k] * sin(w * k);
+
+		re += ck;
+		im -= sk;
+		dre += k * ck;
+		dim -= k * sk;
+	}
+
+	return (dre * re + dim * im) / (re * re + im * im);
+}
+
+// Sum over the stages of the numerator delay minus the denominator delay
+float32_t biquad_group_delay(const float32_t *coeffs, int stages,
+			     float32_t freq)
+{
+	double w = 2.0 * PI * freq / SAMPLING_RATE;
+	double delay = 0.0;
+
+	for (int k = 0; k < stages; k++) {
+		const float32_t *c = &coeffs[5 * k];
+		const double b[3] = { c[0], c[1], c[2] };
+		const double a[3] = { 1.0, -c[3], -c[4] };
+
+		delay += poly_group_delay(b, 3, w) - poly_group_delay(a, 3, w);
+	}
+
+	return delay;
+}
+
+#if defined(CONFIG_APP_EEG_FILTER_FIR) || defined(CONFIG_APP_FILTER_BENCH)
+/*
+ * Taps shrink as the output rate grows so that a high-pass and a low-pass FIR
+ * on every channel stay within a fixed MAC budget. With 8 channels the order
+ * is 401 up to 250 SPS, 399 at 500 SPS and 199 at 1000 SPS. The merged
+ * bandpass keeps the same order at half the cost. The rule is mirrored in
+ * scripts/gen_fir_coeffs.py.
+ */
+#define FILTER_MAC_BUDGET 3200000
+#define FILTER_ORDER \
+	MIN(401, FILTER_MAC_BUDGET / (2 * EEG_MAX_CHANNELS * SAMPLING_RATE) - 1)
+#define FILTER_LEN (FILTER_ORDER + 1)
+#define HIGH_CUTOFF FILTER_HIGHPASS_CUTOFF
+#define LOW_CUTOFF FILTER_LOWPASS_CUTOFF
+
+/* Transition width of the Blackman window in units of fs / taps */
+#define FILTER_BLACKMAN_TRANSITION 5.5f
+
+#ifdef CONFIG_APP_EEG_FILTER_FIR
+BUILD_ASSERT(FILTER_BLACKMAN_TRANSITION * SAMPLING_RATE / FILTER_LEN <
+		     LOW_CUTOFF - HIGH_CUTOFF,
+	     "too few FIR taps for the passband at this output rate, lower "
+	     "APP_EEG_OUTPUT_RATE_SPS to decimate or use APP_EEG_FILTER_IIR");
+#endif
+
+/* One bandpass kernel, or the high-pass followed by the low-pass */
+#ifdef CONFIG_APP_EEG_FIR_CASCADE
+#define FIR_STAGES 2
+#else
+#define FIR_STAGES 1
+#endif
+
+/*
+ * Filter coefficients per stage, shared by every channel. Tables designed at
+ * build time for the configured output rate sit in flash; when the rate, the
+ * order or the stages here no longer match what the generator assumed, the
+ * taps are designed at boot.
+ */
+#include "fir_coeffs.h"
+
+#ifndef FIR_COEFFS_GENERATED
+static float32_t fir_coeffs[FIR_STAGES][FILTER_LEN];
+#endif
+
+#ifdef FILTER_F32
+/*
+ * One FIR stage for every active channel. The delay lines share a circular
+ * buffer of rows, one row per time step holding a sample of each channel,
+ * so every coefficient is loaded once per output frame and applied to all
+ * channels together. Input and output stay planar, [channel][frame].
+ */
+struct fir_bank {
+	const float32_t *coeffs;
+	uint16_t num_taps;
+	uint8_t num_channels;
+	/* Row holding the newest frame */
+	uint16_t pos;
+	float32_t *delay;
+};
+
+// Delay lines, rows sized for the active channels
+static float32_t fir_delay[FIR_STAGES][FILTER_LEN * EEG_MAX_CHANNELS];
+static struct fir_bank bank[FIR_STAGES];
+
+static void fir_bank_reset(struct fir_bank *fir, int num_channels)
+{
+	fir->num_channels = num_channels;
+	fir->pos = 0;
+	memset(fir->delay, 0,
+	       fir->num_taps * num_channels * sizeof(fir->delay[0]));
+}
+
+/*
+ * y[ch][n] = sum(coeffs[k] * x[ch][n - k]) for every channel in one pass.
+ * Each input frame is moved into the delay line before its output is
+ * written, so in and out may be the same block.
+ */
+static void fir_bank_process(struct fir_bank *fir,
+			     const float32_t in[][EEG_BLOCK_FRAMES],
+			     float32_t out[][EEG_BLOCK_FRAMES], size_t count)
+{
+	const int nch = fir->num_channels;
+	const float32_t *c = fir->coeffs;
+	float32_t acc[EEG_MAX_CHANNELS];
+
+	for (size_t i = 0; i < count; i++) {
+		float32_t *newest = &fir->delay[fir->pos * nch];
+
+		for (int ch = 0; ch < nch; ch++) {
+			newest[ch] = in[ch][i];
+			acc[ch] = 0.0f;
+		}
+
+		fir_rows_f32(acc, fir->delay, c, fir->num_taps, fir->pos, nch);
+
+		for (int ch = 0; ch < nch; ch++) {
+			out[ch][i] = acc[ch];
+		}
+		fir->pos = (fir->pos + 1 == fir->num_taps) ? 0 : fir->pos + 1;
+	}
+}
+#endif
 
-	// Calculate lowpass filter coefficients
-	calculate_lp_coeffs(lp_coeffs, LOWPASS_FILTER_ORDER, LOW_CUTOFF,
+#ifdef FILTER_Q31
+/*
+ * q31 path: one arm_fir_fast_q31 instance per channel and stage. Its 2.30
+ * accumulator needs the guard bits eeg_code_to_q31() leaves.
+ */
+#ifndef FIR_COEFFS_GENERATED
+static q31_t fir_coeffs_q31[FIR_STAGES][FILTER_LEN];
+#endif
+static q31_t fir_state_q31[FIR_STAGES][EEG_MAX_CHANNELS]
+			  [BLOCK_SIZE + FILTER_LEN - 1];
+static arm_fir_instance_q31 fir_q31[FIR_STAGES][EEG_MAX_CHANNELS];
+static int q31_channels;
+#endif
+
+static int fir_init(void)
+{
+#ifndef FIR_COEFFS_GENERATED
+#ifdef CONFIG_APP_EEG_FIR_CASCADE
+	calculate_hp_coeffs(fir_coeffs[0], FILTER_ORDER, HIGH_CUTOFF,
 			    SAMPLING_RATE);
+	calculate_lp_coeffs(fir_coeffs[1], FILTER_ORDER, LOW_CUTOFF,
+			    SAMPLING_RATE);
+#else
+	calculate_bp_coeffs(fir_coeffs[0], FILTER_ORDER, HIGH_CUTOFF,
+			    LOW_CUTOFF, SAMPLING_RATE);
+#endif
+
+#ifdef FILTER_Q31
+	for (int s = 0; s < FIR_STAGES; s++) {
+		arm_float_to_q31(fir_coeffs[s], fir_coeffs_q31[s], FILTER_LEN);
+	}
+#endif
+#endif
+
+#ifdef FILTER_F32
+	for (int s = 0; s < FIR_STAGES; s++) {
+		bank[s].coeffs = fir_coeffs[s];
+		bank[s].num_taps = FILTER_LEN;
+		bank[s].delay = fir_delay[s];
+	}
+#endif
+
+	return 0;
+}
+
+static void fir_reset(int num_channels)
+{
+	// Clear the delay lines of every active channel
+	for (int s = 0; s < FIR_STAGES; s++) {
+#ifdef FILTER_F32
+		fir_bank_reset(&bank[s], num_channels);
+#endif
+#ifdef FILTER_Q31
+		for (int ch = 0; ch < num_channels; ch++) {
+			arm_fir_init_q31(&fir_q31[s][ch], FILTER_LEN,
+					 fir_coeffs_q31[s], fir_state_q31[s][ch],
+					 BLOCK_SIZE);
+		}
+#endif
+	}
+#ifdef FILTER_Q31
+	q31_channels = num_channels;
+#endif
+}
+
+#ifdef FILTER_F32
+static void fir_process(const float32_t input[][EEG_BLOCK_FRAMES],
+			float32_t output[][EEG_BLOCK_FRAMES], size_t count)
+{
+	fir_bank_process(&bank[0], input, output, count);
+
+	// Later stages run in place on the output block
+	for (int s = 1; s < FIR_STAGES; s++) {
+		fir_bank_process(&bank[s], output, output, count);
+	}
+}
+#endif
+
+#ifdef FILTER_Q31
+static void fir_process_q31(const q31_t input[][EEG_BLOCK_FRAMES],
+			    q31_t output[][EEG_BLOCK_FRAMES], size_t count)
+{
+	for (int ch = 0; ch < q31_channels; ch++) {
+#ifdef CONFIG_APP_EEG_FIR_CASCADE
+		q31_t hp_output[BLOCK_SIZE];
+
+		arm_fir_fast_q31(&fir_q31[0][ch], input[ch], hp_output, count);
+		arm_fir_fast_q31(&fir_q31[1][ch], hp_output, output[ch], count);
+#else
+		arm_fir_fast_q31(&fir_q31[0][ch], input[ch], output[ch],
+				 count);
+#endif
+	}
+}
+#endif
+
+// |sum(coeffs[k] * e^(-jwk))|
+static float32_t fir_stage_magnitude(const float32_t *coeffs, int num_taps,
+				     float32_t w)
+{
+	float32_t re = 0.0f, im = 0.0f;
+
+	for (int k = 0; k < num_taps; k++) {
+		re += coeffs[k] * arm_cos_f32(w * k);
+		im -= coeffs[k] * arm_sin_f32(w * k);
+	}
+
+	return sqrtf(re * re + im * im);
+}
+
+static float32_t fir_magnitude(float32_t freq)
+{
+	float32_t w = 2.0f * PI * freq / SAMPLING_RATE;
+	float32_t mag = 1.0f;
+
+	for (int s = 0; s < FIR_STAGES; s++) {
+		mag *= fir_stage_magnitude(fir_coeffs[s], FILTER_LEN, w);
+	}
+
+	return mag;
+}
+
+// Symmetric taps: a constant half the order per stage
+static float32_t fir_group_delay(float32_t freq)
+{
+	ARG_UNUSED(freq);
+
+	return FIR_STAGES * FILTER_ORDER / 2.0f;
+}
+
+const struct filter_engine filter_fir = {
+	.name = "fir",
+	.init = fir_init,
+	.reset = fir_reset,
+#ifdef FILTER_F32
+	.process = fir_process,
+#endif
+#ifdef FILTER_Q31
+	.process_q31 = fir_process_q31,
+#endif
+	.magnitude = fir_magnitude,
+	.group_delay = fir_group_delay,
+};
+#endif
+
+#ifdef CONFIG_APP_EEG_FILTER_IIR
+static const struct filter_engine *const engine = &filter_iir;
+#else
+static const struct filter_engine *const engine = &filter_fir;
+#endif
 
-	// Initialize highpass and lowpass filters for each channel
-	for (int i = 0; i < ADS1299_CHANNELS; i++) {
-		arm_fir_init_f32(&hp_instance, HIGHPASS_FILTER_LEN, hp_coeffs,
-				 hp_state[i], BLOCK_SIZE);
-		arm_fir_init_f32(&lp_instance, LOWPASS_FILTER_LEN, lp_coeffs,
-				 lp_state[i], BLOCK_SIZE);
+int initFilters(void)
+{
+	int err = engine->init();
+
+	if (err) {
+		return err;
+	}
+
+	err = notch_init();
+	if (err) {
+		return err;
 	}
 
+	return setFilterChannels(EEG_MAX_CHANNELS);
+}
+
+int setFilterChannels(int num_channels)
+{
+	if (num_channels > EEG_MAX_CHANNELS) {
+		return -EINVAL;
+	}
+
+	engine->reset(num_channels);
+	notch_reset(num_channels);
+
 	return 0;
 }
 
-float32_t filteringEEGData(float32_t input, int channel)
+void filteringEEGBlock(const struct eeg_block *input,
+		       struct eeg_block *output)
 {
-	float32_t hp_output, lp_output;
+#ifdef CONFIG_APP_EEG_Q31
+	engine->process_q31(input->samples, output->samples, input->count);
+#else
+	engine->process(input->samples, output->samples, input->count);
+#endif
+	// 엔진 출력에 제자리로 적용
+	notch_process(output->samples, input->count);
 
-	// Apply highpass filter
-	arm_fir_f32(&hp_instance, &input, &hp_output, BLOCK_SIZE);
+	output->seq = input->seq;
+	output->timestamp = input->timestamp;
+	output->count = input->count;
+	output->num_channels = input->num_channels;
+}
 
-	// Apply lowpass filter
-	arm_fir_f32(&lp_instance, &hp_output, &lp_output, BLOCK_SIZE);
+float32_t filterGroupDelay(float32_t freq)
+{
+	return engine->group_delay(freq) + notch_group_delay(freq);
+}
 
-	return lp_output;
+const struct filter_engine *filterEngine(void)
+{
+	return engine;
 }
 
 SYS_INIT(initFilters, APPLICATION, CONFIG_APPLICATION_INIT_PRIORITY);
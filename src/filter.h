@@ -5,6 +5,135 @@
 #include <arm_math.h>
 #include <arm_const_structs.h>
 
-float32_t filteringEEGData(float32_t input, int channel);
+#include "eeg.h"
+
+#define FILTER_SAMPLING_RATE EEG_OUTPUT_RATE
+/* Passband edges of the EEG filter chain, shared by every engine */
+#define FILTER_HIGHPASS_CUTOFF 2.0f
+#define FILTER_LOWPASS_CUTOFF 40.0f
+/* Frequency the group delay is reported at, inside the alpha band */
+#define FILTER_DELAY_FREQ 10.0f
+
+/* Sample paths compiled in: the configured one, both for the q31 benchmark */
+#if !defined(CONFIG_APP_EEG_Q31) || defined(CONFIG_APP_Q31_BENCH)
+#define FILTER_F32 1
+#endif
+#if defined(CONFIG_APP_EEG_Q31) || defined(CONFIG_APP_Q31_BENCH)
+#define FILTER_Q31 1
+#endif
+
+/* Implementation of the filter chain over planar [channel][frame] blocks */
+struct filter_engine {
+	const char *name;
+	/* Design the coefficients */
+	int (*init)(void);
+	/* Clear the state of the first num_channels channels */
+	void (*reset)(int num_channels);
+#ifdef FILTER_F32
+	void (*process)(const float32_t input[][EEG_BLOCK_FRAMES],
+			float32_t output[][EEG_BLOCK_FRAMES], size_t count);
+#endif
+#ifdef FILTER_Q31
+	/* Same chain on samples scaled as by eeg_code_to_q31() */
+	void (*process_q31)(const q31_t input[][EEG_BLOCK_FRAMES],
+			    q31_t output[][EEG_BLOCK_FRAMES], size_t count);
+#endif
+	/* Designed magnitude response |H| at freq Hz */
+	float32_t (*magnitude)(float32_t freq);
+	/* Group delay at freq Hz, in samples */
+	float32_t (*group_delay)(float32_t freq);
+};
+
+/* Windowed-sinc FIR bandpass (CONFIG_APP_EEG_FILTER_FIR) */
+extern const struct filter_engine filter_fir;
+/* Butterworth biquad cascade (CONFIG_APP_EEG_FILTER_IIR) */
+extern const struct filter_engine filter_iir;
+
+/*
+ * Run the filter chain over every active channel of a block. The output takes
+ * the input's frame count, channels, sequence number and timestamp.
+ */
+void filteringEEGBlock(const struct eeg_block *input,
+		       struct eeg_block *output);
+/* Unity-gain Blackman-windowed sinc lowpass of order + 1 taps */
+void calculate_lp_coeffs(float32_t *coeffs, uint16_t order, float32_t cutoff,
+			 float32_t sampling_rate);
+/*
+ * Response of a biquad cascade at freq Hz, stages of {b0, b1, b2, a1, a2} with
+ * the denominator negated as arm_biquad_cascade_df2T_f32 expects
+ */
+float32_t biquad_magnitude(const float32_t *coeffs, int stages, float32_t freq);
+/* Group delay in samples, same layout as biquad_magnitude() */
+float32_t biquad_group_delay(const float32_t *coeffs, int stages,
+			     float32_t freq);
+/* Group delay of the whole chain at freq Hz, engine and notch, in samples */
+float32_t filterGroupDelay(float32_t freq);
+/* Engine selected by CONFIG_APP_EEG_FILTER_* */
+const struct filter_engine *filterEngine(void);
+/* Reset filter state for the first num_channels active channels */
+int setFilterChannels(int num_channels);
+
+/* acc[ch] += coeff * row[ch], four channels per step as nch is not constant */
+static inline void fir_row_mac_f32(float32_t *acc, const float32_t *row,
+				   float32_t coeff, int nch)
+{
+	int ch = 0;
+
+	for (; ch + 4 <= nch; ch += 4) {
+		acc[ch] += coeff * row[ch];
+		acc[ch + 1] += coeff * row[ch + 1];
+		acc[ch + 2] += coeff * row[ch + 2];
+		acc[ch + 3] += coeff * row[ch + 3];
+	}
+	for (; ch < nch; ch++) {
+		acc[ch] += coeff * row[ch];
+	}
+}
+
+/*
+ * acc[ch] += sum(coeffs[k] * x[ch][n - k]) over a circular buffer of taps
+ * rows of nch samples, the newest one at row pos. Rows are walked by index
+ * from the newest back around to the oldest.
+ */
+static inline void fir_rows_f32(float32_t *acc, const float32_t *delay,
+				const float32_t *coeffs, int taps, int pos,
+				int nch)
+{
+	int r = pos;
+
+	for (int k = 0; k < taps; k++) {
+		fir_row_mac_f32(acc, &delay[r * nch], coeffs[k], nch);
+		r = (r == 0) ? taps - 1 : r - 1;
+	}
+}
+
+/* fir_row_mac_f32() on q31 samples into 64-bit accumulators */
+static inline void fir_row_mac_q31(q63_t *acc, const q31_t *row, q31_t coeff,
+				   int nch)
+{
+	int ch = 0;
+
+	for (; ch + 4 <= nch; ch += 4) {
+		acc[ch] += (q63_t)coeff * row[ch];
+		acc[ch + 1] += (q63_t)coeff * row[ch + 1];
+		acc[ch + 2] += (q63_t)coeff * row[ch + 2];
+		acc[ch + 3] += (q63_t)coeff * row[ch + 3];
+	}
+	for (; ch < nch; ch++) {
+		acc[ch] += (q63_t)coeff * row[ch];
+	}
+}
+
+/* fir_rows_f32() on q31 samples, acc in 2.62 before the >> 31 */
+static inline void fir_rows_q31(q63_t *acc, const q31_t *delay,
+				const q31_t *coeffs, int taps, int pos, int nch)
+{
+	int r = pos;
+
+	for (int k = 0; k < taps; k++) {
+		fir_row_mac_q31(acc, &delay[r * nch], coeffs[k], nch);
+		r = (r == 0) ? taps - 1 : r - 1;
+	}
+}
 
 #endif
@@ -0,0 +1,144 @@
+#include "filter.h"
+
+#include <math.h>
+
+#if defined(CONFIG_APP_EEG_FILTER_IIR) || defined(CONFIG_APP_FILTER_BENCH)
+
+/*
+ * Butterworth high-pass and low-pass of CONFIG_APP_EEG_IIR_ORDER each, run as
+ * one cascade of biquads per channel. At order 4 that is 20 MACs per sample
+ * against the several hundred of the FIR pair.
+ */
+#define IIR_ORDER CONFIG_APP_EEG_IIR_ORDER
+#define IIR_EDGE_STAGES (IIR_ORDER / 2)
+#define IIR_STAGES (2 * IIR_EDGE_STAGES)
+BUILD_ASSERT(IIR_ORDER % 2 == 0, "IIR order must be even");
+
+// Coefficients shared by every channel: {b0, b1, b2, a1, a2} per stage
+static float32_t iir_coeffs[5 * IIR_STAGES];
+static int iir_channels;
+
+#ifdef FILTER_F32
+static float32_t iir_state[EEG_MAX_CHANNELS][2 * IIR_STAGES];
+static arm_biquad_cascade_df2T_instance_f32 iir[EEG_MAX_CHANNELS];
+#endif
+
+#ifdef FILTER_Q31
+/*
+ * q31 path on arm_biquad_cas_df1_32x64_q31: a1 approaches 2 at low cutoffs,
+ * so coefficients are stored halved and the output shifted back by one. The
+ * 64-bit state keeps the 2 Hz high-pass poles close to the unit circle exact.
+ */
+#define IIR_Q31_POST_SHIFT 1
+static q31_t iir_coeffs_q31[5 * IIR_STAGES];
+static q63_t iir_state_q31[EEG_MAX_CHANNELS][4 * IIR_STAGES];
+static arm_biquad_cas_df1_32x64_ins_q31 iir_q31[EEG_MAX_CHANNELS];
+#endif
+
+/*
+ * One second-order section prewarped to the cutoff (bilinear transform). The
+ * denominator is stored negated as arm_biquad_cascade_df2T_f32 expects.
+ */
+static void butterworth_section(float32_t *c, bool highpass, double cutoff,
+				double q)
+{
+	double w0 = 2.0 * PI * cutoff / FILTER_SAMPLING_RATE;
+	double cw = cos(w0);
+	double alpha = sin(w0) / (2.0 * q);
+	double a0 = 1.0 + alpha;
+	// 1 - cos(w0)는 낮은 차단 주파수에서 정밀도를 잃으므로 sin^2로 계산
+	double b1 = highpass ? -(1.0 + cw) : 2.0 * pow(sin(w0 / 2.0), 2);
+
+	c[0] = fabs(b1) / 2.0 / a0;
+	c[1] = b1 / a0;
+	c[2] = c[0];
+	c[3] = 2.0 * cw / a0;
+	c[4] = -(1.0 - alpha) / a0;
+}
+
+static int iir_init(void)
+{
+	for (int k = 0; k < IIR_EDGE_STAGES; k++) {
+		// Q of the k-th pole pair of an IIR_ORDER Butterworth
+		double q = 0.5 / cos(PI * (2 * k + 1) / (2.0 * IIR_ORDER));
+
+		butterworth_section(&iir_coeffs[5 * k], true,
+				    FILTER_HIGHPASS_CUTOFF, q);
+		butterworth_section(&iir_coeffs[5 * (IIR_EDGE_STAGES + k)],
+				    false, FILTER_LOWPASS_CUTOFF, q);
+	}
+
+#ifdef FILTER_Q31
+	for (size_t i = 0; i < ARRAY_SIZE(iir_coeffs); i++) {
+		iir_coeffs_q31[i] = (q31_t)lrint(
+			iir_coeffs[i] * (double)(1U << (31 - IIR_Q31_POST_SHIFT)));
+	}
+#endif
+
+	return 0;
+}
+
+static void iir_reset(int num_channels)
+{
+	// The init clears the state of each channel
+	for (int ch = 0; ch < num_channels; ch++) {
+#ifdef FILTER_F32
+		arm_biquad_cascade_df2T_init_f32(&iir[ch], IIR_STAGES,
+						 iir_coeffs, iir_state[ch]);
+#endif
+#ifdef FILTER_Q31
+		arm_biquad_cas_df1_32x64_init_q31(&iir_q31[ch], IIR_STAGES,
+						  iir_coeffs_q31,
+						  iir_state_q31[ch],
+						  IIR_Q31_POST_SHIFT);
+#endif
+	}
+	iir_channels = num_channels;
+}
+
+#ifdef FILTER_F32
+static void iir_process(const float32_t input[][EEG_BLOCK_FRAMES],
+			float32_t output[][EEG_BLOCK_FRAMES], size_t count)
+{
+	for (int ch = 0; ch < iir_channels; ch++) {
+		arm_biquad_cascade_df2T_f32(&iir[ch], input[ch], output[ch],
+					    count);
+	}
+}
+#endif
+
+#ifdef FILTER_Q31
+static void iir_process_q31(const q31_t input[][EEG_BLOCK_FRAMES],
+			    q31_t output[][EEG_BLOCK_FRAMES], size_t count)
+{
+	for (int ch = 0; ch < iir_channels; ch++) {
+		arm_biquad_cas_df1_32x64_q31(&iir_q31[ch], input[ch],
+					     output[ch], count);
+	}
+}
+#endif
+
+static float32_t iir_magnitude(float32_t freq)
+{
+	return biquad_magnitude(iir_coeffs, IIR_STAGES, freq);
+}
+
+static float32_t iir_group_delay(float32_t freq)
+{
+	return biquad_group_delay(iir_coeffs, IIR_STAGES, freq);
+}
+
+const struct filter_engine filter_iir = {
+	.name = "iir",
+	.init = iir_init,
+	.reset = iir_reset,
+#ifdef FILTER_F32
+	.process = iir_process,
+#endif
+#ifdef FILTER_Q31
+	.process_q31 = iir_process_q31,
+#endif
+	.magnitude = iir_magnitude,
+	.group_delay = iir_group_delay,
+};
+#endif
@@ -0,0 +1,47 @@
+#include "frame_pool.h"
+
+#include <stddef.h>
+#include <zephyr/kernel.h>
+
+BUILD_ASSERT(offsetof(struct eeg_frame, ref) == 0,
+	     "pool blocks are freed through their sample_ref");
+BUILD_ASSERT(offsetof(struct eeg_filtered, ref) == 0,
+	     "pool blocks are freed through their sample_ref");
+BUILD_ASSERT(EEG_POOL_BLOCKS * sizeof(struct eeg_frame) <=
+		     CONFIG_APP_EEG_POOL_MAX_KB * 1024,
+	     "raw frame pool over CONFIG_APP_EEG_POOL_MAX_KB, lower "
+	     "CONFIG_APP_EEG_POOL_MS");
+
+K_MEM_SLAB_DEFINE_STATIC(frame_slab, sizeof(struct eeg_frame), EEG_POOL_BLOCKS,
+			 sizeof(uint32_t));
+K_MEM_SLAB_DEFINE_STATIC(filtered_slab, sizeof(struct eeg_filtered),
+			 EEG_FILTERED_BLOCKS, sizeof(uint32_t));
+
+struct eeg_frame *eeg_frame_alloc(void)
+{
+	struct eeg_frame *frame;
+
+	if (k_mem_slab_alloc(&frame_slab, (void **)&frame, K_NO_WAIT) != 0) {
+		return NULL;
+	}
+	sample_ref_init(&frame->ref, &frame_slab);
+
+	return frame;
+}
+
+uint32_t eeg_frame_pool_free(void)
+{
+	return k_mem_slab_num_free_get(&frame_slab);
+}
+
+struct eeg_filtered *eeg_filtered_alloc(void)
+{
+	struct eeg_filtered *block;
+
+	if (k_mem_slab_alloc(&filtered_slab, (void **)&block, K_NO_WAIT) != 0) {
+		return NULL;
+	}
+	sample_ref_init(&block->ref, &filtered_slab);
+
+	return block;
+}
@@ -0,0 +1,90 @@
+#ifndef __APP_FRAME_POOL_H__
+#define __APP_FRAME_POOL_H__
+
+#include "eeg.h"
+#include "sample_bus.h"
+
+#include <arm_math.h>
+#include <zephyr/sys/util.h>
+
+/* CONFIG_APP_EEG_POOL_MS of frames at the configured data rate, at least 32 */
+#define EEG_POOL_FRAMES                                      \
+	((uint32_t)MAX(32, CONFIG_TI_ADS1299_DATA_RATE_SPS * \
+			   CONFIG_APP_EEG_POOL_MS / 1000))
+
+/*
+ * Raw frames sample bus subscribers may hold on top of the processing queue.
+ * The queue depths of all SAMPLE_TOPIC_RAW subscribers must fit in it, so a
+ * slow subscriber drops its own messages instead of starving acquisition.
+ */
+#define EEG_POOL_BUS_FRAMES 64
+#define EEG_POOL_BLOCKS (EEG_POOL_FRAMES + EEG_POOL_BUS_FRAMES)
+
+/*
+ * Filtered blocks in flight: the queues of the SAMPLE_TOPIC_FILTERED
+ * subscribers (the monitor, and the band powers when enabled) hold up to
+ * EEG_FILTERED_SUB_DEPTH each, and the processing thread fills one more. A
+ * subscriber that falls behind then drops its own blocks instead of
+ * starving the others of pool blocks.
+ */
+#define EEG_FILTERED_SUB_DEPTH 4
+#define EEG_FILTERED_SUBS (1 + IS_ENABLED(CONFIG_APP_EEG_FEATURES))
+#define EEG_FILTERED_BLOCKS (EEG_FILTERED_SUBS * EEG_FILTERED_SUB_DEPTH + 1)
+
+/**
+ * @brief Frame in a pool block, shared between consumers by reference.
+ *
+ * The SPI read lands in @c data directly. Every consumer that keeps the
+ * frame past the call it was handed in takes a reference, and the block
+ * returns to the pool when the last one is dropped.
+ */
+struct eeg_frame {
+	struct sample_ref ref;
+	struct eeg_frame_hdr hdr;
+	uint8_t data[EEG_MAX_FRAME_SIZE];
+};
+
+/**
+ * @brief Take a block from the pool holding one reference. ISR safe.
+ *
+ * @return The frame, or NULL when every block is in use.
+ */
+struct eeg_frame *eeg_frame_alloc(void);
+
+/** @brief Add a reference to @p frame. ISR safe. */
+static inline struct eeg_frame *eeg_frame_ref(struct eeg_frame *frame)
+{
+	sample_ref_get(&frame->ref);
+
+	return frame;
+}
+
+/** @brief Drop a reference, freeing the block on the last one. ISR safe. */
+static inline void eeg_frame_unref(struct eeg_frame *frame)
+{
+	sample_ref_put(&frame->ref);
+}
+
+/** @brief Number of blocks not currently in use. */
+uint32_t eeg_frame_pool_free(void);
+
+/**
+ * @brief Block of filtered samples, published as SAMPLE_TOPIC_FILTERED.
+ *
+ * See eeg_sample_to_volts() for the sample scale.
+ */
+struct eeg_filtered {
+	struct sample_ref ref;
+	/* Delay of the filtered signal behind its DRDY, see eeg_latency_us() */
+	uint32_t latency_us;
+	struct eeg_block block;
+};
+
+/**
+ * @brief Take a filtered block holding one reference.
+ *
+ * @return The block, or NULL when every block is in use.
+ */
+struct eeg_filtered *eeg_filtered_alloc(void);
+
+#endif // __APP_FRAME_POOL_H__
@@ -0,0 +1,47 @@
+#include "frame_queue.h"
+
+// head/tail는 계속 증가하고 mask로 슬롯 위치를 구함. atomic_get/atomic_set이
+// 배리어 역할을 하므로 슬롯 내용은 인덱스 공개 전에 보이게 됨
+
+static inline uint8_t *slot_at(const struct frame_queue *q, uint32_t index)
+{
+	return &q->buf[(index & q->mask) * q->slot_size];
+}
+
+// index부터 버퍼 끝까지 연속된 슬롯 수
+static inline uint32_t contiguous(const struct frame_queue *q, uint32_t index,
+				  uint32_t count)
+{
+	return MIN(count, frame_queue_capacity(q) - (index & q->mask));
+}
+
+void *frame_queue_claim(struct frame_queue *q, uint32_t *count)
+{
+	uint32_t head = atomic_get(&q->head);
+	uint32_t space = frame_queue_capacity(q) -
+			 (head - (uint32_t)atomic_get(&q->tail));
+
+	*count = contiguous(q, head, space);
+
+	return *count != 0 ? slot_at(q, head) : NULL;
+}
+
+void frame_queue_commit(struct frame_queue *q, uint32_t count)
+{
+	atomic_set(&q->head, (uint32_t)atomic_get(&q->head) + count);
+}
+
+void *frame_queue_peek(struct frame_queue *q, uint32_t *count)
+{
+	uint32_t tail = atomic_get(&q->tail);
+	uint32_t filled = (uint32_t)atomic_get(&q->head) - tail;
+
+	*count = contiguous(q, tail, filled);
+
+	return *count != 0 ? slot_at(q, tail) : NULL;
+}
+
+void frame_queue_release(struct frame_queue *q, uint32_t count)
+{
+	atomic_set(&q->tail, (uint32_t)atomic_get(&q->tail) + count);
+}
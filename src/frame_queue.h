@@ -0,0 +1,90 @@
+#ifndef __APP_FRAME_QUEUE_H__
+#define __APP_FRAME_QUEUE_H__
+
+#include <stddef.h>
+#include <stdint.h>
+#include <zephyr/sys/atomic.h>
+#include <zephyr/sys/util.h>
+#include <zephyr/toolchain.h>
+
+/*
+ * Slots are word aligned so records can be accessed in place. The nRF5340
+ * application core has no data cache, so there is no line size to pad to.
+ */
+#define FRAME_QUEUE_SLOT_ALIGN sizeof(uint32_t)
+
+/**
+ * @brief Lock-free single-producer/single-consumer queue of fixed-size slots.
+ *
+ * One context (e.g. an ISR) may produce and one thread may consume without
+ * further locking. Indices run freely and are masked into the slot array,
+ * so the capacity must be a power of two.
+ */
+struct frame_queue {
+	uint8_t *buf;
+	size_t slot_size;
+	uint32_t mask;
+	/* Next slot to fill, only written by the producer */
+	atomic_t head;
+	/* Next slot to consume, only written by the consumer */
+	atomic_t tail;
+};
+
+/**
+ * @brief Statically define a queue of @p count slots of @p slot_size bytes.
+ */
+#define FRAME_QUEUE_DEFINE(name, slot_size_, count)                          \
+	BUILD_ASSERT(IS_POWER_OF_TWO(count), "count must be a power of two"); \
+	static uint8_t __aligned(FRAME_QUEUE_SLOT_ALIGN)                      \
+		_frame_queue_buf_##name[ROUND_UP(slot_size_,                  \
+						 FRAME_QUEUE_SLOT_ALIGN) *    \
+					(count)];                             \
+	static struct frame_queue name = {                                    \
+		.buf = _frame_queue_buf_##name,                               \
+		.slot_size = ROUND_UP(slot_size_, FRAME_QUEUE_SLOT_ALIGN),    \
+		.mask = (count) - 1,                                          \
+	}
+
+/** @brief Number of slots the queue holds. */
+static inline uint32_t frame_queue_capacity(const struct frame_queue *q)
+{
+	return q->mask + 1;
+}
+
+/** @brief Number of filled slots, exact for the consumer. */
+static inline uint32_t frame_queue_count(struct frame_queue *q)
+{
+	return (uint32_t)atomic_get(&q->head) - (uint32_t)atomic_get(&q->tail);
+}
+
+/** @brief Number of free slots, exact for the producer. */
+static inline uint32_t frame_queue_space(struct frame_queue *q)
+{
+	return frame_queue_capacity(q) - frame_queue_count(q);
+}
+
+/**
+ * @brief Producer: get free slots to fill in place.
+ *
+ * @param[out] count Number of contiguous free slots at the returned address.
+ *
+ * @return First free slot, or NULL when the queue is full.
+ */
+void *frame_queue_claim(struct frame_queue *q, uint32_t *count);
+
+/** @brief Producer: publish @p count slots filled after frame_queue_claim(). */
+void frame_queue_commit(struct frame_queue *q, uint32_t count);
+
+/**
+ * @brief Consumer: get filled slots to read in place.
+ *
+ * @param[out] count Number of contiguous filled slots at the returned address.
+ *
+ * @return Oldest filled slot, or NULL when the queue is empty.
+ */
+void *frame_queue_peek(struct frame_queue *q, uint32_t *count);
+
+/** @brief Consumer: free @p count slots read after frame_queue_peek(). */
+void frame_queue_release(struct frame_queue *q, uint32_t count);
+
+#endif // __APP_FRAME_QUEUE_H__
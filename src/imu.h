@@ -0,0 +1,20 @@
+#ifndef __APP_IMU_H__
+#define __APP_IMU_H__
+
+#include "sample_bus.h"
+
+#include <stdint.h>
+#include <zephyr/drivers/sensor.h>
+
+/** @brief BMI270 sample, published as SAMPLE_TOPIC_IMU. */
+struct imu_sample {
+	struct sample_ref ref;
+	/* Uptime of the data-ready interrupt in ms */
+	int64_t uptime;
+	/* Acceleration in G */
+	struct sensor_value accel[3];
+	/* Angular rate in degrees/s */
+	struct sensor_value gyro[3];
+};
+
+#endif // __APP_IMU_H__
@@ -0,0 +1,176 @@
+/*
+ * Console monitor: prints filtered EEG samples, epoch features, signal
+ * quality and IMU samples from the sample bus.
+ * It has shallow queues and drops its oldest messages, so a slow UART only
+ * costs monitor output. Epochs and quality windows arrive a few times a
+ * second and get their own queue, so the sample stream cannot push them out.
+ */
+#include "epoch.h"
+#include "frame_pool.h"
+#include "imu.h"
+#include "quality.h"
+#include "sample_bus.h"
+
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+#ifdef CONFIG_SHELL
+#include <zephyr/shell/shell.h>
+#endif
+
+LOG_MODULE_REGISTER(MONITOR, CONFIG_APP_LOG_LEVEL);
+
+// UART 출력은 250 Hz 이하로 솎아냄
+#define MONITOR_PRINT_RATE 250
+#define MONITOR_PRINT_DIV \
+	MAX(1, EEG_OUTPUT_RATE / MONITOR_PRINT_RATE)
+
+SAMPLE_SUB_DEFINE(monitor_sub,
+		  BIT(SAMPLE_TOPIC_FILTERED) | BIT(SAMPLE_TOPIC_IMU),
+		  EEG_FILTERED_SUB_DEPTH, SAMPLE_DROP_OLDEST);
+// 에포크와 품질 창 하나씩
+SAMPLE_SUB_DEFINE(monitor_summary_sub,
+		  BIT(SAMPLE_TOPIC_EPOCH) | BIT(SAMPLE_TOPIC_QUALITY), 2,
+		  SAMPLE_DROP_OLDEST);
+
+static void print_filtered(const struct eeg_filtered *filtered)
+{
+	const struct eeg_block *block = &filtered->block;
+
+	static uint32_t print_count;
+
+	for (uint32_t i = 0; i < block->count; i++) {
+		if (++print_count >= MONITOR_PRINT_DIV) {
+			print_count = 0;
+			printk("%f\n",
+			       (double)eeg_sample_to_volts(block->samples[0][i]));
+		}
+	}
+}
+
+// 에포크마다 채널별 한 줄 (uV 단위)
+static void print_epoch(const struct eeg_epoch *epoch)
+{
+	for (int ch = 0; ch < epoch->num_channels; ch++) {
+		const struct eeg_epoch_channel *c = &epoch->channel[ch];
+
+		LOG_INF("Epoch %u ch%d: activity %.2f uV^2, mobility %.3f, "
+			"complexity %.3f, rms %.2f uV, line length %.1f uV, "
+			"zcr %.1f/s",
+			epoch->seq, ch, (double)(c->activity * 1e12f),
+			(double)c->mobility, (double)c->complexity,
+			(double)(c->rms * 1e6f),
+			(double)(c->line_length * 1e6f),
+			(double)c->zero_crossing_rate);
+	}
+}
+
+// 품질 창마다 채널별 한 줄
+static void print_quality(const struct eeg_quality *quality)
+{
+	for (int ch = 0; ch < quality->num_channels; ch++) {
+		const struct eeg_channel_quality *q = &quality->channel[ch];
+
+		LOG_INF("Quality %u ch%d: score %u, flags 0x%02x, rms %.2f uV, "
+			"line %.2f, emg %.2f, railed %u, saturated %u",
+			quality->seq, ch, q->score, q->flags,
+			(double)(q->rms * 1e6f), (double)q->line_ratio,
+			(double)q->emg_ratio, q->railed, q->saturated);
+	}
+}
+
+static void print_imu(const struct imu_sample *sample)
+{
+	const struct sensor_value *accel = sample->accel;
+	const struct sensor_value *gyro = sample->gyro;
+
+	LOG_INF("AX: %d.%06d; AY: %d.%06d; AZ: %d.%06d; "
+		"GX: %d.%06d; GY: %d.%06d; GZ: %d.%06d;",
+		accel[0].val1, accel[0].val2, accel[1].val1, accel[1].val2,
+		accel[2].val1, accel[2].val2, gyro[0].val1, gyro[0].val2,
+		gyro[1].val1, gyro[1].val2, gyro[2].val1, gyro[2].val2);
+}
+
+static void monitor_thread(void)
+{
+	struct sample_msg msg;
+
+	sample_bus_subscribe(&monitor_sub);
+
+	while (1) {
+		sample_sub_get(&monitor_sub, &msg, K_FOREVER);
+
+		switch (msg.topic) {
+		case SAMPLE_TOPIC_FILTERED:
+			print_filtered(CONTAINER_OF(msg.obj,
+						    struct eeg_filtered, ref));
+			break;
+		case SAMPLE_TOPIC_IMU:
+			print_imu(CONTAINER_OF(msg.obj, struct imu_sample, ref));
+			break;
+		default:
+			break;
+		}
+		sample_ref_put(msg.obj);
+	}
+}
+
+static void monitor_summary_thread(void)
+{
+	struct sample_msg msg;
+
+	sample_bus_subscribe(&monitor_summary_sub);
+
+	while (1) {
+		sample_sub_get(&monitor_summary_sub, &msg, K_FOREVER);
+
+		switch (msg.topic) {
+		case SAMPLE_TOPIC_EPOCH:
+			print_epoch(CONTAINER_OF(msg.obj, struct eeg_epoch,
+						 ref));
+			break;
+		case SAMPLE_TOPIC_QUALITY:
+			print_quality(CONTAINER_OF(msg.obj, struct eeg_quality,
+						   ref));
+			break;
+		default:
+			break;
+		}
+		sample_ref_put(msg.obj);
+	}
+}
+
+#define MONITOR_STACKSIZE 2048
+#define MONITOR_PRIORITY 5
+K_THREAD_DEFINE(monitor_thread_id, MONITOR_STACKSIZE, monitor_thread, NULL,
+		NULL, NULL, MONITOR_PRIORITY, 0, 0);
+K_THREAD_DEFINE(monitor_summary_thread_id, MONITOR_STACKSIZE,
+		monitor_summary_thread, NULL, NULL, NULL, MONITOR_PRIORITY, 0,
+		0);
+
+#ifdef CONFIG_SHELL
+static int cmd_monitor_on(const struct shell *sh, size_t argc, char **argv)
+{
+	sample_bus_subscribe(&monitor_sub);
+	sample_bus_subscribe(&monitor_summary_sub);
+
+	return 0;
+}
+
+static int cmd_monitor_off(const struct shell *sh, size_t argc, char **argv)
+{
+	sample_bus_unsubscribe(&monitor_sub);
+	sample_bus_unsubscribe(&monitor_summary_sub);
+
+	return 0;
+}
+
+SHELL_STATIC_SUBCMD_SET_CREATE(
+	sub_monitor,
+	SHELL_CMD(on, NULL,
+		  "Print filtered EEG, epoch features, signal quality and "
+		  "IMU samples",
+		  cmd_monitor_on),
+	SHELL_CMD(off, NULL, "Stop printing", cmd_monitor_off),
+	SHELL_SUBCMD_SET_END);
+SHELL_CMD_REGISTER(monitor, &sub_monitor, "Console sample monitor", NULL);
+#endif
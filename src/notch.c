@@ -0,0 +1,113 @@
+#include "notch.h"
+#include "filter.h"
+
+#include <math.h>
+
+#if NOTCH_FREQ > 0
+/*
+ * Harmonics of the mains frequency that fit below the output Nyquist
+ * frequency, at most CONFIG_APP_EEG_NOTCH_HARMONICS. Each is a biquad per
+ * channel, 5 MACs per sample, so the default two harmonics stay near two dozen
+ * cycles per sample on the Cortex-M33.
+ */
+#define NOTCH_STAGES \
+	MIN(CONFIG_APP_EEG_NOTCH_HARMONICS, \
+	    (FILTER_SAMPLING_RATE - 1) / 2 / NOTCH_FREQ)
+BUILD_ASSERT(NOTCH_STAGES > 0,
+	     "the mains frequency is above the output Nyquist frequency");
+
+/*
+ * -3 dB width of every notch in Hz. Wide enough for the mains frequency to
+ * drift by a few tenths of a hertz, narrow enough to leave the band below
+ * 40 Hz untouched.
+ */
+#define NOTCH_BANDWIDTH 2.0
+
+// Coefficients shared by every channel: {b0, b1, b2, a1, a2} per stage
+static float32_t notch_coeffs[5 * NOTCH_STAGES];
+static int notch_channels;
+
+#ifdef CONFIG_APP_EEG_Q31
+// b1 reaches -2 at low notch frequencies, stored halved as in filter_iir.c
+#define NOTCH_Q31_POST_SHIFT 1
+static q31_t notch_coeffs_q31[5 * NOTCH_STAGES];
+static q63_t notch_state[EEG_MAX_CHANNELS][4 * NOTCH_STAGES];
+static arm_biquad_cas_df1_32x64_ins_q31 notch[EEG_MAX_CHANNELS];
+#else
+static float32_t notch_state[EEG_MAX_CHANNELS][2 * NOTCH_STAGES];
+static arm_biquad_cascade_df2T_instance_f32 notch[EEG_MAX_CHANNELS];
+#endif
+
+// Unity-gain notch at freq Hz (bilinear transform), denominator negated
+static void notch_section(float32_t *c, double freq)
+{
+	double w0 = 2.0 * PI * freq / FILTER_SAMPLING_RATE;
+	double cw = cos(w0);
+	double alpha = sin(w0) / (2.0 * freq / NOTCH_BANDWIDTH);
+	double a0 = 1.0 + alpha;
+
+	c[0] = 1.0 / a0;
+	c[1] = -2.0 * cw / a0;
+	c[2] = c[0];
+	c[3] = 2.0 * cw / a0;
+	c[4] = -(1.0 - alpha) / a0;
+}
+
+int notch_init(void)
+{
+	for (int k = 0; k < NOTCH_STAGES; k++) {
+		notch_section(&notch_coeffs[5 * k], (k + 1) * NOTCH_FREQ);
+	}
+
+#ifdef CONFIG_APP_EEG_Q31
+	for (size_t i = 0; i < ARRAY_SIZE(notch_coeffs); i++) {
+		notch_coeffs_q31[i] = (q31_t)lrint(
+			notch_coeffs[i] *
+			(double)(1U << (31 - NOTCH_Q31_POST_SHIFT)));
+	}
+#endif
+
+	return 0;
+}
+
+void notch_reset(int num_channels)
+{
+	// The init clears the state of each channel
+	for (int ch = 0; ch < num_channels; ch++) {
+#ifdef CONFIG_APP_EEG_Q31
+		arm_biquad_cas_df1_32x64_init_q31(&notch[ch], NOTCH_STAGES,
+						  notch_coeffs_q31,
+						  notch_state[ch],
+						  NOTCH_Q31_POST_SHIFT);
+#else
+		arm_biquad_cascade_df2T_init_f32(&notch[ch], NOTCH_STAGES,
+						 notch_coeffs, notch_state[ch]);
+#endif
+	}
+	notch_channels = num_channels;
+}
+
+void notch_process(eeg_sample_t data[][EEG_BLOCK_FRAMES], size_t count)
+{
+	// 바이쿼드는 샘플 단위로 진행하므로 입력과 출력이 같아도 됨
+	for (int ch = 0; ch < notch_channels; ch++) {
+#ifdef CONFIG_APP_EEG_Q31
+		arm_biquad_cas_df1_32x64_q31(&notch[ch], data[ch], data[ch],
+					     count);
+#else
+		arm_biquad_cascade_df2T_f32(&notch[ch], data[ch], data[ch],
+					    count);
+#endif
+	}
+}
+
+float32_t notch_magnitude(float32_t freq)
+{
+	return biquad_magnitude(notch_coeffs, NOTCH_STAGES, freq);
+}
+
+float32_t notch_group_delay(float32_t freq)
+{
+	return biquad_group_delay(notch_coeffs, NOTCH_STAGES, freq);
+}
+#endif
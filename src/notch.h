@@ -0,0 +1,66 @@
+#ifndef __APP_NOTCH_H__
+#define __APP_NOTCH_H__
+
+#include "eeg.h"
+
+#include <stddef.h>
+#include <zephyr/toolchain.h>
+
+/*
+ * Mains frequency notched after the filter engine, 0 without a notch. Every
+ * harmonic up to CONFIG_APP_EEG_NOTCH_HARMONICS that lies below the output
+ * Nyquist frequency gets one biquad per channel.
+ */
+#define NOTCH_FREQ CONFIG_APP_EEG_NOTCH_FREQ
+
+#if NOTCH_FREQ > 0
+/** @brief Design the sections, before the first notch_reset(). */
+int notch_init(void);
+
+/** @brief Clear the state of the first num_channels channels. */
+void notch_reset(int num_channels);
+
+/**
+ * @brief Notch count frames of every active channel in place.
+ *
+ * Runs on the configured sample path, float or q31.
+ */
+void notch_process(eeg_sample_t data[][EEG_BLOCK_FRAMES], size_t count);
+
+/** @brief Designed magnitude response |H| at freq Hz. */
+float32_t notch_magnitude(float32_t freq);
+
+/** @brief Group delay at freq Hz, in output samples. */
+float32_t notch_group_delay(float32_t freq);
+#else
+static inline int notch_init(void)
+{
+	return 0;
+}
+
+static inline void notch_reset(int num_channels)
+{
+	ARG_UNUSED(num_channels);
+}
+
+static inline void notch_process(eeg_sample_t data[][EEG_BLOCK_FRAMES],
+				 size_t count)
+{
+	ARG_UNUSED(data);
+	ARG_UNUSED(count);
+}
+
+static inline float32_t notch_magnitude(float32_t freq)
+{
+	ARG_UNUSED(freq);
+	return 1.0f;
+}
+
+static inline float32_t notch_group_delay(float32_t freq)
+{
+	ARG_UNUSED(freq);
+	return 0.0f;
+}
+#endif
+
+#endif // __APP_NOTCH_H__
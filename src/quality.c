@@ -0,0 +1,288 @@
+#include "quality.h"
+#include "filter.h"
+#include "unpack.h"
+
+#include <math.h>
+#include <stddef.h>
+#include <string.h>
+#include <zephyr/init.h>
+#include <zephyr/kernel.h>
+
+#ifdef CONFIG_APP_EEG_QUALITY
+BUILD_ASSERT(offsetof(struct eeg_quality, ref) == 0,
+	     "pool blocks are freed through their sample_ref");
+BUILD_ASSERT(2 * QUALITY_MAINS_FREQ < EEG_OUTPUT_RATE,
+	     "the mains frequency is above the output Nyquist frequency");
+BUILD_ASSERT(EEG_BLOCK_FRAMES <= QUALITY_WINDOW * EEG_DECIMATION,
+	     "a block must not span more than one window boundary");
+
+/*
+ * EMG band: a second-order Butterworth high-pass at the top of the EEG band,
+ * on the signal before the filter chain. Mains harmonics above the
+ * fundamental count as EMG.
+ */
+#define QUALITY_EMG_CUTOFF FILTER_LOWPASS_CUTOFF
+/* Codes from here to full scale count as railed, about 95 % */
+#define QUALITY_RAIL_CODE 0x7a0000
+/* Filtered RMS below the ADS1299 input noise (about 0.14 uV at gain 24) */
+#define QUALITY_FLAT_RMS 0.05e-6f
+
+// 구독자에게 전달 중인 품질 지표
+#define QUALITY_BLOCKS 2
+K_MEM_SLAB_DEFINE_STATIC(quality_slab, sizeof(struct eeg_quality),
+			 QUALITY_BLOCKS, sizeof(uint32_t));
+
+// 고역 통과 {b0, b1, b2, a1, a2}, 분모는 df2T 관례대로 부호 반전
+static float32_t hp_coeffs[5];
+// 고역 통과 후의 전원 전력을 입력 기준으로 되돌리는 |H(f_mains)|^2
+static float32_t hp_mains_gain;
+// Goertzel 계수 2 cos(2 pi f_mains / fs)
+static float32_t goertzel_coeff;
+
+// 채널별 현재 창의 누적값
+struct quality_acc {
+	// 고역 통과 df2T 상태, 창 경계를 넘어 이어짐
+	float32_t z1;
+	float32_t z2;
+	// 고역 통과 출력의 Goertzel 상태
+	float32_t s1;
+	float32_t s2;
+	// 고역 통과 출력과 필터 출력의 제곱합
+	float32_t hf;
+	float32_t eeg;
+	uint32_t railed;
+	uint32_t saturated;
+	// 창 경계를 넘은 블록에서 다음 창에 속하는 원시 프레임의 집계
+	uint32_t next_railed;
+	uint32_t next_saturated;
+};
+
+static struct quality_acc acc[EEG_MAX_CHANNELS];
+static int channels;
+// 현재 창의 출력 샘플 수와 원시 프레임 수
+static size_t samples;
+static uint32_t raw_frames;
+static uint32_t next_raw_frames;
+// 리셋 직후의 창은 필터가 전극 DC 오프셋에 안정되는 중이라 발행하지 않음
+static bool settling;
+
+static void quality_clear(void)
+{
+	for (int ch = 0; ch < channels; ch++) {
+		struct quality_acc *a = &acc[ch];
+
+		a->s1 = 0.0f;
+		a->s2 = 0.0f;
+		a->hf = 0.0f;
+		a->eeg = 0.0f;
+		a->railed = a->next_railed;
+		a->saturated = a->next_saturated;
+		a->next_railed = 0;
+		a->next_saturated = 0;
+	}
+	samples = 0;
+	raw_frames = next_raw_frames;
+	next_raw_frames = 0;
+}
+
+void quality_reset(int num_channels)
+{
+	memset(acc, 0, sizeof(acc[0]) * num_channels);
+	next_raw_frames = 0;
+	channels = num_channels;
+	settling = true;
+	quality_clear();
+}
+
+void quality_push_raw(struct eeg_frame *const *frames, size_t count,
+		      const uint8_t *taken, size_t outputs,
+		      const struct eeg_layout *layout)
+{
+	uint32_t railed[EEG_MAX_CHANNELS] = { 0 };
+	uint32_t saturated[EEG_MAX_CHANNELS] = { 0 };
+	size_t left = QUALITY_WINDOW - samples;
+	// 현재 창의 마지막 출력 샘플을 취한 프레임까지가 이 창의 몫
+	size_t split = count;
+
+	if (outputs >= left) {
+		split = (taken != NULL ? taken[left - 1] : left - 1) + 1;
+	}
+
+	unpack_count_rails(frames, split, layout, QUALITY_RAIL_CODE, railed,
+			   saturated);
+	for (int ch = 0; ch < channels; ch++) {
+		acc[ch].railed += railed[ch];
+		acc[ch].saturated += saturated[ch];
+		railed[ch] = 0;
+		saturated[ch] = 0;
+	}
+	raw_frames += split;
+
+	unpack_count_rails(&frames[split], count - split, layout,
+			   QUALITY_RAIL_CODE, railed, saturated);
+	for (int ch = 0; ch < channels; ch++) {
+		acc[ch].next_railed += railed[ch];
+		acc[ch].next_saturated += saturated[ch];
+	}
+	next_raw_frames += count - split;
+}
+
+static void quality_accumulate(const struct eeg_block *input,
+			       const struct eeg_block *filtered, size_t first,
+			       size_t count)
+{
+	const float32_t b0 = hp_coeffs[0], b1 = hp_coeffs[1];
+	const float32_t b2 = hp_coeffs[2], a1 = hp_coeffs[3];
+	const float32_t a2 = hp_coeffs[4];
+	const float32_t g = goertzel_coeff;
+
+	for (int ch = 0; ch < channels; ch++) {
+		struct quality_acc *a = &acc[ch];
+		const eeg_sample_t *in = &input->samples[ch][first];
+		const eeg_sample_t *out = &filtered->samples[ch][first];
+		float32_t z1 = a->z1, z2 = a->z2;
+		float32_t s1 = a->s1, s2 = a->s2;
+		float32_t hf = a->hf, eeg = a->eeg;
+
+		for (size_t i = 0; i < count; i++) {
+			float32_t x = eeg_sample_to_volts(in[i]);
+			float32_t y = eeg_sample_to_volts(out[i]);
+			float32_t h = b0 * x + z1;
+			float32_t s = h + g * s1 - s2;
+
+			z1 = b1 * x + a1 * h + z2;
+			z2 = b2 * x + a2 * h;
+			s2 = s1;
+			s1 = s;
+			hf += h * h;
+			eeg += y * y;
+		}
+		a->z1 = z1;
+		a->z2 = z2;
+		a->s1 = s1;
+		a->s2 = s2;
+		a->hf = hf;
+		a->eeg = eeg;
+	}
+	samples += count;
+}
+
+static void quality_finish(struct eeg_quality *quality)
+{
+	const float32_t n = samples;
+
+	for (int ch = 0; ch < channels; ch++) {
+		const struct quality_acc *a = &acc[ch];
+		struct eeg_channel_quality *q = &quality->channel[ch];
+		float32_t eeg = a->eeg / n;
+		// 창 길이가 1초라 전원 주파수가 정확히 한 빈에 놓임
+		float32_t mains_hp = 2.0f *
+				     (a->s1 * a->s1 + a->s2 * a->s2 -
+				      goertzel_coeff * a->s1 * a->s2) /
+				     (n * n);
+		float32_t emg = MAX(a->hf / n - mains_hp, 0.0f);
+		float32_t line = mains_hp / hp_mains_gain;
+		float32_t clean;
+
+		q->flags = 0;
+		q->railed = MIN(a->railed, UINT16_MAX);
+		q->saturated = MIN(a->saturated, UINT16_MAX);
+		q->rms = sqrtf(eeg);
+		q->line_ratio = eeg > 0.0f ? line / eeg : 0.0f;
+		q->emg_ratio = eeg > 0.0f ? emg / eeg : 0.0f;
+
+		if (raw_frames > 0 && 2 * a->railed >= raw_frames) {
+			q->flags |= QUALITY_RAILED;
+		}
+		if (a->saturated > 0) {
+			q->flags |= QUALITY_SATURATED;
+		}
+		if (q->rms < QUALITY_FLAT_RMS) {
+			q->flags |= QUALITY_FLAT;
+		}
+		if (q->line_ratio > 1.0f) {
+			q->flags |= QUALITY_LINE_NOISE;
+		}
+		if (q->emg_ratio > 1.0f) {
+			q->flags |= QUALITY_EMG;
+		}
+
+		// 잡음 전력이 EEG 전력과 같으면 절반, 잘린 프레임 비율만큼 감점
+		if (q->flags & (QUALITY_RAILED | QUALITY_FLAT)) {
+			q->score = 0;
+		} else {
+			clean = 1.0f - (float32_t)a->saturated /
+					       MAX(raw_frames, 1U);
+			q->score = lrintf(100.0f * MAX(clean, 0.0f) /
+					  ((1.0f + q->line_ratio) *
+					   (1.0f + q->emg_ratio)));
+		}
+	}
+	quality->num_channels = channels;
+}
+
+// 구독자가 있으면 끝난 창을 발행
+static void quality_publish(uint32_t seq)
+{
+	struct eeg_quality *quality;
+
+	if (!sample_bus_has_subscribers(SAMPLE_TOPIC_QUALITY) ||
+	    k_mem_slab_alloc(&quality_slab, (void **)&quality, K_NO_WAIT) !=
+		    0) {
+		return;
+	}
+	sample_ref_init(&quality->ref, &quality_slab);
+
+	quality->seq = seq;
+	quality_finish(quality);
+	sample_bus_publish(SAMPLE_TOPIC_QUALITY, &quality->ref);
+	sample_ref_put(&quality->ref);
+}
+
+void quality_push(const struct eeg_block *input,
+		  const struct eeg_block *filtered)
+{
+	size_t done = 0;
+
+	while (done < input->count) {
+		size_t n = MIN(input->count - done, QUALITY_WINDOW - samples);
+
+		quality_accumulate(input, filtered, done, n);
+		done += n;
+		if (samples == QUALITY_WINDOW) {
+			if (!settling) {
+				quality_publish(input->seq +
+						(done - 1) * EEG_DECIMATION);
+			}
+			settling = false;
+			quality_clear();
+		}
+	}
+}
+
+// 2차 버터워스 고역 통과 (쌍선형 변환, Q = 1/sqrt(2))
+static int quality_init(void)
+{
+	double w0 = 2.0 * PI * QUALITY_EMG_CUTOFF / EEG_OUTPUT_RATE;
+	double cw = cos(w0);
+	double alpha = sin(w0) / M_SQRT2;
+	double a0 = 1.0 + alpha;
+	float32_t gain;
+
+	hp_coeffs[0] = (1.0 + cw) / 2.0 / a0;
+	hp_coeffs[1] = -(1.0 + cw) / a0;
+	hp_coeffs[2] = hp_coeffs[0];
+	hp_coeffs[3] = 2.0 * cw / a0;
+	hp_coeffs[4] = -(1.0 - alpha) / a0;
+
+	gain = biquad_magnitude(hp_coeffs, 1, QUALITY_MAINS_FREQ);
+	hp_mains_gain = gain * gain;
+	goertzel_coeff = 2.0 * cos(2.0 * PI * QUALITY_MAINS_FREQ /
+				   EEG_OUTPUT_RATE);
+	quality_reset(EEG_MAX_CHANNELS);
+
+	return 0;
+}
+
+SYS_INIT(quality_init, APPLICATION, CONFIG_APPLICATION_INIT_PRIORITY);
+#endif
@@ -0,0 +1,115 @@
+#ifndef __APP_QUALITY_H__
+#define __APP_QUALITY_H__
+
+#include "eeg.h"
+#include "frame_pool.h"
+#include "sample_bus.h"
+
+#include <stddef.h>
+#include <stdint.h>
+#include <zephyr/toolchain.h>
+
+/*
+ * Signal quality of every channel over back-to-back windows of one second:
+ * railing and clipping of the raw codes, mains pickup and high-frequency
+ * (EMG) power before the filter chain against the EEG band power after it.
+ */
+#define QUALITY_WINDOW EEG_OUTPUT_RATE
+#define QUALITY_MAINS_FREQ CONFIG_APP_EEG_QUALITY_MAINS_FREQ
+
+/* Flags of struct eeg_channel_quality */
+/* Half the codes or more within 5 % of full scale, e.g. electrode off */
+#define QUALITY_RAILED BIT(0)
+/* Codes clipped at the end of the 24-bit range */
+#define QUALITY_SATURATED BIT(1)
+/* EEG band below the ADS1299 input noise: stuck or shorted input */
+#define QUALITY_FLAT BIT(2)
+/* Mains power above the EEG band power */
+#define QUALITY_LINE_NOISE BIT(3)
+/* Power above the EEG band, mains excluded, above the EEG band power */
+#define QUALITY_EMG BIT(4)
+
+/** @brief Quality of one channel over one window. */
+struct eeg_channel_quality {
+	/* 100 for a clean channel, 0 when railed or flat */
+	uint8_t score;
+	/* QUALITY_* flags */
+	uint8_t flags;
+	/* Raw frames near the rails and clipped in the window */
+	uint16_t railed;
+	uint16_t saturated;
+	/* RMS of the filtered EEG band in V */
+	float32_t rms;
+	/* Mains and EMG power over the EEG band power */
+	float32_t line_ratio;
+	float32_t emg_ratio;
+};
+
+/** @brief Quality of every channel, published as SAMPLE_TOPIC_QUALITY. */
+struct eeg_quality {
+	struct sample_ref ref;
+	/* Sequence number of the last frame of the window, see eeg_frame_hdr */
+	uint32_t seq;
+	uint8_t num_channels;
+	struct eeg_channel_quality channel[EEG_MAX_CHANNELS];
+};
+
+#ifdef CONFIG_APP_EEG_QUALITY
+/**
+ * @brief Start over with num_channels channels. The first window after a
+ * reset is not published while the filters settle.
+ */
+void quality_reset(int num_channels);
+
+/**
+ * @brief Count the railed and clipped codes of raw frames, before anything
+ * writes over them.
+ *
+ * Call once per block ahead of quality_push(). The frames up to the one the
+ * window's last output sample is taken at count in the current window, the
+ * rest in the next.
+ *
+ * @param count Number of raw frames.
+ * @param taken Frame every output sample is taken at, see
+ *              decimate_process(), or NULL when not decimating.
+ * @param outputs Number of output samples the frames decimate to.
+ */
+void quality_push_raw(struct eeg_frame *const *frames, size_t count,
+		      const uint8_t *taken, size_t outputs,
+		      const struct eeg_layout *layout);
+
+/**
+ * @brief Add a block at the output rate, before and after the filter chain.
+ *
+ * A few MACs per sample and channel. Publishes one eeg_quality for every
+ * window the block completes, when SAMPLE_TOPIC_QUALITY has subscribers.
+ */
+void quality_push(const struct eeg_block *input,
+		  const struct eeg_block *filtered);
+#else
+static inline void quality_reset(int num_channels)
+{
+	ARG_UNUSED(num_channels);
+}
+
+static inline void quality_push_raw(struct eeg_frame *const *frames,
+				    size_t count, const uint8_t *taken,
+				    size_t outputs,
+				    const struct eeg_layout *layout)
+{
+	ARG_UNUSED(frames);
+	ARG_UNUSED(count);
+	ARG_UNUSED(taken);
+	ARG_UNUSED(outputs);
+	ARG_UNUSED(layout);
+}
+
+static inline void quality_push(const struct eeg_block *input,
+				const struct eeg_block *filtered)
+{
+	ARG_UNUSED(input);
+	ARG_UNUSED(filtered);
+}
+#endif
+
+#endif // __APP_QUALITY_H__
@@ -0,0 +1,140 @@
+#include "sample_bus.h"
+
+#include <zephyr/kernel.h>
+#ifdef CONFIG_SHELL
+#include <zephyr/shell/shell.h>
+#endif
+
+static sys_slist_t subscribers = SYS_SLIST_STATIC_INIT(&subscribers);
+// 구독 목록 보호 (ISR에서도 발행하므로 스핀락)
+static struct k_spinlock bus_lock;
+// 토픽별 구독자 수
+static atomic_t topic_subs[SAMPLE_TOPIC_COUNT];
+
+// 큐에 남은 메시지의 참조를 모두 반환
+static void sub_drain(struct sample_sub *sub)
+{
+	struct sample_msg msg;
+
+	while (k_msgq_get(sub->msgq, &msg, K_NO_WAIT) == 0) {
+		sample_ref_put(msg.obj);
+	}
+}
+
+void sample_bus_subscribe(struct sample_sub *sub)
+{
+	k_spinlock_key_t key = k_spin_lock(&bus_lock);
+
+	if (!sub->subscribed) {
+		sub->subscribed = true;
+		sys_slist_append(&subscribers, &sub->node);
+		for (int topic = 0; topic < SAMPLE_TOPIC_COUNT; topic++) {
+			if (sub->topics & BIT(topic)) {
+				atomic_inc(&topic_subs[topic]);
+			}
+		}
+	}
+	k_spin_unlock(&bus_lock, key);
+}
+
+void sample_bus_unsubscribe(struct sample_sub *sub)
+{
+	k_spinlock_key_t key = k_spin_lock(&bus_lock);
+
+	if (sub->subscribed) {
+		sub->subscribed = false;
+		sys_slist_find_and_remove(&subscribers, &sub->node);
+		for (int topic = 0; topic < SAMPLE_TOPIC_COUNT; topic++) {
+			if (sub->topics & BIT(topic)) {
+				atomic_dec(&topic_subs[topic]);
+			}
+		}
+	}
+	k_spin_unlock(&bus_lock, key);
+
+	sub_drain(sub);
+}
+
+bool sample_bus_has_subscribers(enum sample_topic topic)
+{
+	return atomic_get(&topic_subs[topic]) != 0;
+}
+
+// 가득 찬 큐는 구독자 정책에 따라 가장 오래된 것 또는 새 메시지를 버림
+static void sub_deliver(struct sample_sub *sub, const struct sample_msg *msg)
+{
+	struct sample_msg oldest;
+
+	sample_ref_get(msg->obj);
+	if (k_msgq_put(sub->msgq, msg, K_NO_WAIT) == 0) {
+		return;
+	}
+
+	atomic_inc(&sub->drops);
+	if (sub->policy == SAMPLE_DROP_OLDEST &&
+	    k_msgq_get(sub->msgq, &oldest, K_NO_WAIT) == 0) {
+		sample_ref_put(oldest.obj);
+		if (k_msgq_put(sub->msgq, msg, K_NO_WAIT) == 0) {
+			return;
+		}
+	}
+	sample_ref_put(msg->obj);
+}
+
+void sample_bus_publish(enum sample_topic topic, struct sample_ref *obj)
+{
+	const struct sample_msg msg = {
+		.topic = topic,
+		.obj = obj,
+	};
+	struct sample_sub *sub;
+	k_spinlock_key_t key;
+
+	if (!sample_bus_has_subscribers(topic)) {
+		return;
+	}
+
+	key = k_spin_lock(&bus_lock);
+	SYS_SLIST_FOR_EACH_CONTAINER(&subscribers, sub, node) {
+		if (sub->topics & BIT(topic)) {
+			sub_deliver(sub, &msg);
+		}
+	}
+	k_spin_unlock(&bus_lock, key);
+}
+
+#ifdef CONFIG_SHELL
+static int cmd_bus(const struct shell *sh, size_t argc, char **argv)
+{
+	struct sample_sub *sub;
+	struct {
+		const char *name;
+		uint32_t used, depth, drops;
+	} snap[8];
+	size_t n = 0;
+	k_spinlock_key_t key;
+
+	// 스핀락 안에서는 출력하지 않도록 스냅샷만 모음
+	key = k_spin_lock(&bus_lock);
+	SYS_SLIST_FOR_EACH_CONTAINER(&subscribers, sub, node) {
+		if (n == ARRAY_SIZE(snap)) {
+			break;
+		}
+		snap[n].name = sub->name;
+		snap[n].used = k_msgq_num_used_get(sub->msgq);
+		snap[n].depth = sub->msgq->max_msgs;
+		snap[n].drops = atomic_get(&sub->drops);
+		n++;
+	}
+	k_spin_unlock(&bus_lock, key);
+
+	for (size_t i = 0; i < n; i++) {
+		shell_print(sh, "%-12s queued %u/%u, dropped %u", snap[i].name,
+			    snap[i].used, snap[i].depth, snap[i].drops);
+	}
+
+	return 0;
+}
+
+SHELL_CMD_REGISTER(bus, NULL, "Sample bus subscribers", cmd_bus);
+#endif
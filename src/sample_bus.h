@@ -0,0 +1,138 @@
+#ifndef __APP_SAMPLE_BUS_H__
+#define __APP_SAMPLE_BUS_H__
+
+#include <stdint.h>
+#include <zephyr/kernel.h>
+#include <zephyr/sys/atomic.h>
+#include <zephyr/sys/slist.h>
+#include <zephyr/sys/util.h>
+
+/*
+ * Sample bus: publishers hand out references to pool blocks once, every
+ * subscriber receives its own reference through its own message queue.
+ * Publishing never blocks, a full subscriber queue loses messages according
+ * to the subscriber's drop policy and never stalls the publisher.
+ */
+
+/** @brief Kinds of data published on the bus. */
+enum sample_topic {
+	/* struct eeg_frame, ADS1299 frame at EEG_OUTPUT_RATE */
+	SAMPLE_TOPIC_RAW,
+	/* struct eeg_filtered, block of filtered samples */
+	SAMPLE_TOPIC_FILTERED,
+	/* struct imu_sample, BMI270 accelerometer and gyroscope sample */
+	SAMPLE_TOPIC_IMU,
+	/* struct eeg_features, band powers once per FEATURES_HOP frames */
+	SAMPLE_TOPIC_FEATURES,
+	/* struct eeg_epoch, time-domain features once per EPOCH_LEN frames */
+	SAMPLE_TOPIC_EPOCH,
+	/* struct eeg_quality, signal quality once per second */
+	SAMPLE_TOPIC_QUALITY,
+	SAMPLE_TOPIC_COUNT,
+};
+
+/** @brief What a subscriber loses when its queue is full. */
+enum sample_drop_policy {
+	/* Keep the queued messages, drop the one being published */
+	SAMPLE_DROP_NEWEST,
+	/* Drop the oldest queued message to make room */
+	SAMPLE_DROP_OLDEST,
+};
+
+/**
+ * @brief Reference count heading every object published on the bus.
+ *
+ * Must be the first member of a block allocated from @c slab, the block is
+ * returned to it when the last reference is dropped.
+ */
+struct sample_ref {
+	atomic_t count;
+	struct k_mem_slab *slab;
+};
+
+/** @brief Message delivered to a subscriber. */
+struct sample_msg {
+	enum sample_topic topic;
+	/* Reference owned by the subscriber, drop with sample_ref_put() */
+	struct sample_ref *obj;
+};
+
+/** @brief Subscriber, define with SAMPLE_SUB_DEFINE(). */
+struct sample_sub {
+	const char *name;
+	/* BIT(topic) of every topic received */
+	uint32_t topics;
+	enum sample_drop_policy policy;
+	struct k_msgq *msgq;
+	/* Messages lost to a full queue */
+	atomic_t drops;
+	bool subscribed;
+	sys_snode_t node;
+};
+
+/**
+ * @brief Statically define a subscriber with a queue of @p depth messages.
+ *
+ * @param topics BIT() mask of enum sample_topic values to receive.
+ */
+#define SAMPLE_SUB_DEFINE(_name, _topics, _depth, _policy)                  \
+	K_MSGQ_DEFINE(_sample_sub_msgq_##_name, sizeof(struct sample_msg),   \
+		      _depth, sizeof(void *));                               \
+	static struct sample_sub _name = {                                   \
+		.name = #_name,                                              \
+		.topics = _topics,                                           \
+		.policy = _policy,                                           \
+		.msgq = &_sample_sub_msgq_##_name,                           \
+	}
+
+/** @brief Initialize a block taken from @p slab with one reference. */
+static inline void sample_ref_init(struct sample_ref *ref,
+				   struct k_mem_slab *slab)
+{
+	ref->slab = slab;
+	atomic_set(&ref->count, 1);
+}
+
+/** @brief Add a reference. ISR safe. */
+static inline void sample_ref_get(struct sample_ref *ref)
+{
+	atomic_inc(&ref->count);
+}
+
+/** @brief Drop a reference, freeing the block on the last one. ISR safe. */
+static inline void sample_ref_put(struct sample_ref *ref)
+{
+	/* atomic_dec() returns the count before the decrement */
+	if (atomic_dec(&ref->count) == 1) {
+		k_mem_slab_free(ref->slab, ref);
+	}
+}
+
+/** @brief Start delivering the subscriber's topics to it, if not yet. */
+void sample_bus_subscribe(struct sample_sub *sub);
+
+/** @brief Stop delivering to the subscriber and drop what it has queued. */
+void sample_bus_unsubscribe(struct sample_sub *sub);
+
+/** @brief Whether anyone receives @p topic, to skip building unused data. */
+bool sample_bus_has_subscribers(enum sample_topic topic);
+
+/**
+ * @brief Deliver a reference to @p obj to every subscriber of @p topic.
+ *
+ * Never blocks, ISR safe. The caller keeps its own reference.
+ */
+void sample_bus_publish(enum sample_topic topic, struct sample_ref *obj);
+
+/**
+ * @brief Wait for the subscriber's next message.
+ *
+ * @return 0 on success, -EAGAIN on timeout.
+ */
+static inline int sample_sub_get(struct sample_sub *sub,
+				 struct sample_msg *msg, k_timeout_t timeout)
+{
+	return k_msgq_get(sub->msgq, msg, timeout);
+}
+
+#endif // __APP_SAMPLE_BUS_H__
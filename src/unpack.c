@@ -0,0 +1,128 @@
+#include "unpack.h"
+
+#include <errno.h>
+#include <zephyr/sys/byteorder.h>
+#include <zephyr/sys/util.h>
+#include <zephyr/toolchain.h>
+
+// CHnSET.GAIN(비트 6:4) 코드별 PGA 게인, 7은 예약
+#define CHNSET_GAIN(chnset) (((chnset) >> 4) & 0x7)
+static const uint8_t pga_gain[] = { 1, 2, 4, 6, 8, 12, 24 };
+
+// 모든 PGA 게인이 EEG_GAIN의 약수이므로 q31 배율은 정수
+BUILD_ASSERT(EEG_GAIN == 24, "every PGA gain must divide EEG_GAIN");
+
+static uint8_t gain[EEG_MAX_CHANNELS];
+#ifdef CONFIG_APP_EEG_Q31
+// q31 = CLAMP(code, -limit, limit) * mult, without a 64-bit product
+static int32_t mult[EEG_MAX_CHANNELS];
+static int32_t limit[EEG_MAX_CHANNELS];
+#else
+static float32_t lsb_volts[EEG_MAX_CHANNELS];
+#endif
+
+/*
+ * Sign-extended 24-bit big-endian code at p. The word is loaded from the byte
+ * before the sample, which is always in the frame (the status word or the
+ * previous sample): REV puts the sample in the low 24 bits and the shift pair
+ * sign-extends it, LDR + REV + SBFX instead of three byte loads and the ORs.
+ */
+static ALWAYS_INLINE int32_t load_code(const uint8_t *p)
+{
+	uint32_t word = UNALIGNED_GET((const uint32_t *)(p - 1));
+
+	return (int32_t)(__REV(word) << 8) >> 8;
+}
+
+int unpack_set_gains(const uint8_t *chnset, int num_channels)
+{
+	for (int ch = 0; ch < num_channels; ch++) {
+		if (CHNSET_GAIN(chnset[ch]) >= ARRAY_SIZE(pga_gain)) {
+			return -EINVAL;
+		}
+	}
+
+	for (int ch = 0; ch < num_channels; ch++) {
+		gain[ch] = pga_gain[CHNSET_GAIN(chnset[ch])];
+#ifdef CONFIG_APP_EEG_Q31
+		mult[ch] = (EEG_GAIN / gain[ch]) << EEG_Q31_SHIFT;
+		limit[ch] = INT32_MAX / mult[ch];
+#else
+		lsb_volts[ch] = EEG_VREF / gain[ch] / (1 << 23);
+#endif
+	}
+
+	return 0;
+}
+
+void unpack_frames(struct eeg_frame *const *frames, size_t count,
+		   const struct eeg_layout *layout, struct eeg_block *block)
+{
+	block->seq = frames[0]->hdr.seq;
+	block->timestamp = frames[0]->hdr.timestamp;
+	block->count = count;
+	block->num_channels = layout->num_channels;
+
+	// 채널 배율을 레지스터에 두고 채널 단위로 한 번에 디코딩
+	for (int ch = 0; ch < layout->num_channels; ch++) {
+		const uint16_t offset = layout->offset[ch];
+		eeg_sample_t *out = block->samples[ch];
+#ifdef CONFIG_APP_EEG_Q31
+		const int32_t m = mult[ch];
+		const int32_t lim = limit[ch];
+
+		for (size_t i = 0; i < count; i++) {
+			int32_t code = load_code(&frames[i]->data[offset]);
+
+			out[i] = CLAMP(code, -lim, lim) * m;
+		}
+#else
+		const float32_t scale = lsb_volts[ch];
+
+		for (size_t i = 0; i < count; i++) {
+			int32_t code = load_code(&frames[i]->data[offset]);
+
+			out[i] = (float32_t)code * scale;
+		}
+#endif
+	}
+}
+
+void unpack_count_rails(struct eeg_frame *const *frames, size_t count,
+			const struct eeg_layout *layout, int32_t rail,
+			uint32_t *railed, uint32_t *saturated)
+{
+	for (int ch = 0; ch < layout->num_channels; ch++) {
+		const uint16_t offset = layout->offset[ch];
+		uint32_t near = 0;
+		uint32_t clipped = 0;
+
+		for (size_t i = 0; i < count; i++) {
+			int32_t code = load_code(&frames[i]->data[offset]);
+			// 음수는 1을 더해 뒤집음, -0x800000은 0x7fffff가 됨
+			int32_t mag = code < 0 ? -(code + 1) : code;
+
+			near += mag >= rail;
+			clipped += mag == 0x7fffff;
+		}
+		railed[ch] += near;
+		saturated[ch] += clipped;
+	}
+}
+
+void unpack_encode(const struct eeg_block *block, size_t i,
+		   const struct eeg_layout *layout, uint8_t *data)
+{
+	for (int ch = 0; ch < layout->num_channels; ch++) {
+		eeg_sample_t sample = block->samples[ch][i];
+#ifdef CONFIG_APP_EEG_Q31
+		int32_t code = (sample >> EEG_Q31_SHIFT) * gain[ch] / EEG_GAIN;
+#else
+		int32_t code = (int32_t)lrintf(CLAMP(
+			sample / lsb_volts[ch], -8388608.0f, 8388607.0f));
+#endif
+
+		sys_put_be24(CLAMP(code, -8388608, 8388607),
+			     &data[layout->offset[ch]]);
+	}
+}
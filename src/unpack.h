@@ -0,0 +1,56 @@
+#ifndef __APP_UNPACK_H__
+#define __APP_UNPACK_H__
+
+#include "eeg.h"
+#include "frame_pool.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * @brief Set the scale of each active channel from its CHnSET value.
+ *
+ * Float samples come out in volts at the channel's own PGA gain. q31 samples
+ * keep the EEG_GAIN scale of eeg_code_to_q31() so eeg_q31_to_volts() holds
+ * for every channel; channels at a lower gain saturate beyond
+ * 4 * VREF / EEG_GAIN volts.
+ *
+ * @param chnset CHnSET register of each active channel, in channel order.
+ *
+ * @return 0 on success, -EINVAL for the reserved gain code. The scales are
+ *         left unchanged on error.
+ */
+int unpack_set_gains(const uint8_t *chnset, int num_channels);
+
+/**
+ * @brief Decode the active channels of @p count (<= EEG_BLOCK_FRAMES) frames
+ * into a planar block, samples[ch][i] from frames[i].
+ *
+ * The block takes its sequence number and timestamp from the first frame.
+ */
+void unpack_frames(struct eeg_frame *const *frames, size_t count,
+		   const struct eeg_layout *layout, struct eeg_block *block);
+
+/**
+ * @brief Count the codes of each active channel in @p count frames that are
+ * at or beyond +-@p rail, and those at the end of the 24-bit range.
+ *
+ * @param[in,out] railed Incremented per channel for |code| >= rail.
+ * @param[in,out] saturated Incremented per channel for clipped codes.
+ */
+void unpack_count_rails(struct eeg_frame *const *frames, size_t count,
+			const struct eeg_layout *layout, int32_t rail,
+			uint32_t *railed, uint32_t *saturated);
+
+/**
+ * @brief Interleave frame @p i of a block back into the ADS1299 wire format
+ * for the transport: one saturated 24-bit big-endian code per active channel
+ * at the layout's offsets, at each channel's gain. The inverse of
+ * unpack_frames().
+ *
+ * @param data Frame the codes are written to.
+ */
+void unpack_encode(const struct eeg_block *block, size_t i,
+		   const struct eeg_layout *layout, uint8_t *data);
+
+#endif // __APP_UNPACK_H__
@@ -5,6 +5,8 @@
  */
 
 #include "ti_ads1299_driver_spi.h"
+#include "ti_ads1299_priv.h"
+#include <string.h>
 #include <zephyr/types.h>
 #include <zephyr/sys/printk.h>
 #include <ncs_version.h>
@@ -17,9 +19,6 @@
 #include <zephyr/drivers/spi.h>
 #include <zephyr/drivers/gpio.h>
 
-#define DELAY_REG 2
-#define DELAY_PARAM 10
-
 // command
 #define WAKEUP 0x02
 #define STANDBY 0x04
@@ -57,61 +56,98 @@
 #define MISC2_REG 0x16
 #define CONFIG4_REG 0x17
 
+/* CONFIG1.DR code for CONFIG_TI_ADS1299_DATA_RATE_SPS (16000 >> DR) */
+#define ADS1299_DR_CODE (LOG2(16000 / CONFIG_TI_ADS1299_DATA_RATE_SPS))
+
+/*
+ * Register access stays slow enough that one byte outlasts tSDECODE
+ * (4 tCLK, ~2 us), multi-byte opcodes then need no extra spacing.
+ */
+#define ADS1299_REG_SCLK_HZ MHZ(1)
+
+/* Command decode (4 tCLK) and RESET (18 tCLK) times at fCLK = 2.048 MHz */
+#define ADS1299_T_SDECODE_US 2
+#define ADS1299_T_RESET_US 9
+
+/* CHnSET for powered channels at boot: gain 24, inputs shorted */
+#define ADS1299_CHNSET_DEFAULT \
+	(ADS1299_REG_CHNSET_GAIN_24 | ADS1299_REG_CHNSET_INPUT_SHORTED)
+
 #define ADS1299_SPI_OPERATION \
 	(SPI_WORD_SET(8) | SPI_TRANSFER_MSB | SPI_MODE_CPHA)
 #if DT_NUM_INST_STATUS_OKAY(DT_DRV_COMPAT) == 0
 #warning "TI ADS1299 driver enabled without any devices"
 #endif
 
-/* Data structure to store ADS1299 data */
-struct ads1299_data {
-	uint8_t chip_id;
-} adsdata;
-
-struct ti_ads1299_config {
-	struct spi_dt_spec spi;
-};
-
-// ADS1299 레지스터 쓰기 함수
-static int write_reg(const struct device *dev, uint8_t reg, uint8_t value)
+// ADS1299 레지스터 연속 쓰기 (WREG 버스트)
+static int write_regs(const struct device *dev, uint8_t reg,
+		      const uint8_t *values, size_t count)
 {
-	uint8_t tx_data[] = {
-		0x40 | reg, 0x00, value
-	}; // 첫 바이트: 0x40 (쓰기 명령) | 레지스터 주소
-	struct spi_buf tx_buf = { .buf = tx_data, .len = sizeof(tx_data) };
-	struct spi_buf_set tx_bufs = { .buffers = &tx_buf, .count = 1 };
+	if (count == 0 || reg + count > ADS1299_NUM_REGS) {
+		return -EINVAL;
+	}
+
+	// 첫 바이트: 0x40 (쓰기 명령) | 시작 주소, 두 번째: 레지스터 수 - 1
+	uint8_t opcode[] = { 0x40 | reg, count - 1 };
+	struct spi_buf tx_buf[] = {
+		{ .buf = opcode, .len = sizeof(opcode) },
+		{ .buf = (uint8_t *)values, .len = count },
+	};
+	struct spi_buf_set tx_bufs = { .buffers = tx_buf,
+				       .count = ARRAY_SIZE(tx_buf) };
 
 	const struct ti_ads1299_config *ads1299_config = dev->config;
-	if (spi_write_dt(&ads1299_config->spi, &tx_bufs) != 0) {
+	struct ads1299_data *data = dev->data;
+	if (spi_write(ads1299_config->spi.bus, &data->reg_spi, &tx_bufs) != 0) {
 		printk("SPI write failed");
 		return -EIO;
 	}
-	k_msleep(DELAY_REG);
+	k_busy_wait(ADS1299_T_SDECODE_US);
+
+	// 쓴 값으로 섀도우 갱신 (섀도우에서 바로 쓴 경우는 제외)
+	if (values != &data->regs[reg]) {
+		memcpy(&data->regs[reg], values, count);
+	}
+	data->dirty &= ~GENMASK(reg + count - 1, reg);
 
 	return 0;
 }
 
-// ADS1299 레지스터 읽기 함수
-static int read_reg(const struct device *dev, uint8_t reg, uint8_t *value)
+// ADS1299 레지스터 연속 읽기 (RREG 버스트)
+static int read_regs(const struct device *dev, uint8_t reg, uint8_t *values,
+		     size_t count)
 {
-	uint8_t tx_data[] = {
-		0x20 | reg, 0x00
-	}; // 첫 바이트: 0x20 (읽기 명령) | 레지스터 주소
-	uint8_t rx_data[3];
-	struct spi_buf tx_buf = { .buf = tx_data, .len = sizeof(tx_data) };
-	struct spi_buf rx_buf = { .buf = rx_data, .len = sizeof(rx_data) };
+	if (count == 0 || reg + count > ADS1299_NUM_REGS) {
+		return -EINVAL;
+	}
+
+	// 첫 바이트: 0x20 (읽기 명령) | 시작 주소, 두 번째: 레지스터 수 - 1
+	uint8_t opcode[] = { 0x20 | reg, count - 1 };
+	struct spi_buf tx_buf = { .buf = opcode, .len = sizeof(opcode) };
+	// 옵코드 2 바이트 동안의 응답은 버림
+	struct spi_buf rx_buf[] = {
+		{ .buf = NULL, .len = sizeof(opcode) },
+		{ .buf = values, .len = count },
+	};
 	struct spi_buf_set tx_bufs = { .buffers = &tx_buf, .count = 1 };
-	struct spi_buf_set rx_bufs = { .buffers = &rx_buf, .count = 1 };
+	struct spi_buf_set rx_bufs = { .buffers = rx_buf,
+				       .count = ARRAY_SIZE(rx_buf) };
 
 	const struct ti_ads1299_config *ads1299_config = dev->config;
-	if (spi_transceive_dt(&ads1299_config->spi, &tx_bufs, &rx_bufs) != 0) {
+	struct ads1299_data *data = dev->data;
+	if (spi_transceive(ads1299_config->spi.bus, &data->reg_spi, &tx_bufs,
+			   &rx_bufs) != 0) {
 		printk("SPI transceive failed");
 		return -EIO;
 	}
-	k_msleep(DELAY_REG);
+	k_busy_wait(ADS1299_T_SDECODE_US);
 
 	//TODO Bit1 개가 쉬프트되는 문제
-	*value = rx_data[2]; // 세 번째 바이트가 실제 데이터
+	if (values != &data->regs[reg]) {
+		memcpy(&data->regs[reg], values, count);
+	}
+	data->dirty &= ~GENMASK(reg + count - 1, reg);
+
 	return 0;
 }
 
@@ -121,143 +157,393 @@ static int send_command(const struct device *dev, uint8_t command)
 	struct spi_buf_set tx_bufs = { .buffers = &tx_buf, .count = 1 };
 
 	const struct ti_ads1299_config *ads1299_config = dev->config;
-	if (spi_write_dt(&ads1299_config->spi, &tx_bufs) != 0) {
+	struct ads1299_data *data = dev->data;
+	if (spi_write(ads1299_config->spi.bus, &data->reg_spi, &tx_bufs) != 0) {
 		printk("SPI write SDATAC command failed");
 		return -EIO;
 	}
 
-	// SDATAC 명령 후 잠시 대기
-	k_msleep(DELAY_REG);
+	// 명령 디코딩 대기, RESET은 18 tCLK 동안 다른 명령을 받지 않음
+	k_busy_wait(command == RESET ? ADS1299_T_RESET_US :
+				       ADS1299_T_SDECODE_US);
 
 	return 0;
 }
 
-static int init(const struct device *dev)
+/* SCLK rates tried for sample reads, slowest first */
+static const uint32_t ads1299_sclk_hz[ADS1299_NUM_SCLK] = {
+	MHZ(1), MHZ(2), MHZ(4), MHZ(8), MHZ(16),
+};
+
+static void spi_configs_init(const struct device *dev)
 {
-	int err;
+	const struct ti_ads1299_config *ads1299_config = dev->config;
+	struct ads1299_data *data = dev->data;
+	const uint32_t max_hz = ads1299_config->spi.config.frequency;
+
+	data->reg_spi = ads1299_config->spi.config;
+	data->reg_spi.frequency = MIN(max_hz, ADS1299_REG_SCLK_HZ);
 
+	for (int i = 0; i < ADS1299_NUM_SCLK; i++) {
+		data->data_spi_cfgs[i] = ads1299_config->spi.config;
+		data->data_spi_cfgs[i].frequency =
+			MIN(max_hz, ads1299_sclk_hz[i]);
+	}
+	data->data_spi = &data->data_spi_cfgs[0];
+}
+
+/*
+ * Pick the slowest SCLK that shifts a whole frame out in at most half a DRDY
+ * period, leaving the other half for register access and other devices on
+ * the bus. Each rate has its own spi_config because the SPI driver only
+ * reconfigures when it is handed a different config pointer.
+ */
+static void select_sclk(const struct device *dev)
+{
 	const struct ti_ads1299_config *ads1299_config = dev->config;
-	err = spi_is_ready_dt(&ads1299_config->spi);
-	if (!err) {
-		printk("Error: SPI device is not ready, err: %d\n", err);
-		return err;
+	struct ads1299_data *data = dev->data;
+	const uint32_t frame_bits =
+		8 * ads1299_frame_len(ads1299_config->num_devices,
+				      data->channel_mask);
+	const uint32_t budget_ns =
+		NSEC_PER_SEC / ads1299_sps(data->data_rate) / 2;
+	int i;
+
+	for (i = 0; i < ADS1299_NUM_SCLK - 1; i++) {
+		uint64_t frame_ns = (uint64_t)frame_bits * NSEC_PER_SEC /
+				    data->data_spi_cfgs[i].frequency;
+
+		if (frame_ns <= budget_ns) {
+			break;
+		}
 	}
 
-	// See Detail ADS1299 Data Sheet(Figure 67. Initial Flow at Power-Up)
-	// 1. Send SDATAC command
-	err = send_command(dev, SDATAC);
-	if (err != 0) {
-		printk("Failed to send SDATAC command, err: %d\n", err);
-		return err;
+	data->data_spi = &data->data_spi_cfgs[i];
+}
+
+/*
+ * CHnSET through BIAS_SENSP for a channel mask: channels in mask get chnset,
+ * the others are powered down with shorted inputs as recommended by the
+ * datasheet. BIAS sensing on the positive side follows the mask.
+ */
+static void channel_regs(uint8_t mask, uint8_t chnset,
+			 uint8_t regs[ADS1299_NUM_CHANNELS + 1])
+{
+	for (int i = 0; i < ADS1299_NUM_CHANNELS; i++) {
+		regs[i] = ADS1299_REG_CHNSET_CHANNEL_OFF |
+			  ADS1299_REG_CHNSET_INPUT_SHORTED;
+
+		if (mask & BIT(i)) {
+			regs[i] = chnset & ~ADS1299_REG_CHNSET_CHANNEL_OFF;
+		}
 	}
+	regs[ADS1299_NUM_CHANNELS] = mask;
+}
 
-	/* Write to GPIO register, set all pins to driven-low output */
-	err = write_reg(dev, GPIO_REG,
-			ADS1299_REG_GPIO_GPIOC4_OUTPUT |
-				ADS1299_REG_GPIO_GPIOD4_LOW |
-				ADS1299_REG_GPIO_GPIOC3_OUTPUT |
-				ADS1299_REG_GPIO_GPIOD3_LOW |
-				ADS1299_REG_GPIO_GPIOC2_OUTPUT |
-				ADS1299_REG_GPIO_GPIOD2_LOW |
-				ADS1299_REG_GPIO_GPIOC1_OUTPUT |
-				ADS1299_REG_GPIO_GPIOD1_LOW);
-	if (err != 0) {
-		printk("Failed to set CONFIG3 register\n");
-		return err;
+/*
+ * CONFIG1 also selects the readback mode: a lone chip uses multiple readback,
+ * a chain of chips sharing CS and DRDY shifts its frames through DAISY_IN.
+ */
+static uint8_t config1_value(const struct device *dev, uint8_t dr)
+{
+	const struct ti_ads1299_config *ads1299_config = dev->config;
+	uint8_t mode = ads1299_config->num_devices > 1 ?
+			       ADS1299_REG_CONFIG1_DAISY_CHAIN_MODE :
+			       ADS1299_REG_CONFIG1_MULTI_READBACK_MODE;
+
+	return ADS1299_REG_CONFIG1_RESERVED_VALUE | mode | dr;
+}
+
+/* ID and the lead-off status registers cannot be written */
+#define ADS1299_READ_ONLY_REGS \
+	(BIT(ID_REG) | BIT(LOFF_STATP_REG) | BIT(LOFF_STATN_REG))
+
+/*
+ * Update the shadow copy of @p count registers from @p reg, marking the ones
+ * whose value changes dirty. Nothing goes on the bus until apply_regs().
+ */
+static int stage_regs(const struct device *dev, uint8_t reg,
+		      const uint8_t *values, size_t count)
+{
+	struct ads1299_data *data = dev->data;
+
+	if (count == 0 || reg + count > ADS1299_NUM_REGS ||
+	    (GENMASK(reg + count - 1, reg) & ADS1299_READ_ONLY_REGS)) {
+		return -EINVAL;
 	}
 
-	// 2. Enable internal reference buffer, BIASREF_INT=1
-	err = write_reg(dev, CONFIG3_REG,
-			ADS1299_REG_CONFIG3_REFBUF_ENABLED |
-				ADS1299_REG_CONFIG3_RESERVED_VALUE |
-				ADS1299_REG_CONFIG3_BIASBUF_ENABLED |
-				ADS1299_REG_CONFIG3_BIASREF_INT);
-	if (err != 0) {
-		printk("Failed to set CONFIG3 register\n");
-		return err;
+	for (size_t i = 0; i < count; i++) {
+		if (data->regs[reg + i] != values[i]) {
+			data->regs[reg + i] = values[i];
+			data->dirty |= BIT(reg + i);
+		}
 	}
 
-	// 3. Wait for reference buffer to settle
-	k_sleep(K_MSEC(150)); // > 150 ms for internal reference buffer
+	return 0;
+}
 
-	// 4. Configure device
-	// Set CONFIG1: DR = fMOD/4096
-	err = write_reg(dev, CONFIG1_REG,
-			ADS1299_REG_CONFIG1_RESERVED_VALUE |
-				ADS1299_REG_CONFIG1_FMOD_DIV_BY_4096);
-	if (err != 0) {
-		printk("Failed to set CONFIG1 register\n");
-		return err;
+/* Clean writable registers a burst may rewrite to avoid another opcode */
+#define ADS1299_MERGE_GAP 2
+
+/*
+ * Write the dirty registers in as few WREG bursts as possible: runs of dirty
+ * registers separated by at most ADS1299_MERGE_GAP clean writable ones are
+ * sent together, the clean ones being rewritten with their shadow value.
+ */
+static int write_dirty_regs(const struct device *dev)
+{
+	struct ads1299_data *data = dev->data;
+	int err;
+
+	while (data->dirty != 0) {
+		uint32_t dirty = data->dirty;
+		int first = find_lsb_set(dirty) - 1;
+		int last = first;
+
+		for (int reg = first + 1; reg < ADS1299_NUM_REGS; reg++) {
+			if (BIT(reg) & ADS1299_READ_ONLY_REGS) {
+				break;
+			}
+			if (BIT(reg) & dirty) {
+				last = reg;
+			} else if (reg - last > ADS1299_MERGE_GAP) {
+				break;
+			}
+		}
+
+		err = write_regs(dev, first, &data->regs[first],
+				 last - first + 1);
+		if (err != 0) {
+			return err;
+		}
 	}
 
-	// Set CONFIG2: Test signal
-	err = write_reg(dev, CONFIG2_REG, ADS1299_REG_CONFIG2_RESERVED_VALUE);
-	if (err != 0) {
-		printk("Failed to set CONFIG2 register\n");
-		return err;
+	return 0;
+}
+
+/* Channels whose CHnSET has the power-down bit cleared in the shadow */
+static uint8_t shadow_channel_mask(const struct ads1299_data *data)
+{
+	uint8_t mask = 0;
+
+	for (int i = 0; i < ADS1299_NUM_CHANNELS; i++) {
+		if (!(data->regs[CH1SET_REG + i] &
+		      ADS1299_REG_CHNSET_CHANNEL_OFF)) {
+			mask |= BIT(i);
+		}
+	}
+
+	return mask;
+}
+
+/*
+ * Push the dirty registers to the chip. Registers can only be written
+ * outside RDATAC, so a streaming device is taken out of it (SDATAC), the
+ * dirty registers are burst-written and RDATAC is resumed, with the DPPI
+ * stream paused around the window. Returns the number of DRDY periods the
+ * window overlapped, i.e. samples that were not read, or a negative errno.
+ */
+static int apply_regs(const struct device *dev)
+{
+	struct ads1299_data *data = dev->data;
+	const uint32_t sps = ads1299_sps(data->data_rate);
+	uint8_t mask = shadow_channel_mask(data);
+	bool streaming = false;
+	uint32_t start_cyc, window_us;
+	int err, resume_err;
+
+	if (data->dirty == 0) {
+		return 0;
 	}
 
-	// Set All Channels
-	for (int i = 0; i < 2; i++) {
-		err = write_reg(dev, CH1SET_REG + i,
-				ADS1299_REG_CHNSET_CHANNEL_ON |
-					ADS1299_REG_CHNSET_GAIN_24 |
-					ADS1299_REG_CHNSET_INPUT_SHORTED);
+#ifdef CONFIG_TI_ADS1299_DPPI_STREAM
+	const struct ti_ads1299_config *ads1299_config = dev->config;
+
+	streaming = data->stream.running;
+	// 스트림 프레임 길이가 바뀌는 변경은 스트림을 다시 시작해야 함
+	if (streaming &&
+	    ads1299_frame_len(ads1299_config->num_devices, mask) !=
+		    ads1299_frame_len(ads1299_config->num_devices,
+				      data->channel_mask)) {
+		return -EBUSY;
+	}
+#endif
+
+	start_cyc = k_cycle_get_32();
+
+#ifdef CONFIG_TI_ADS1299_DPPI_STREAM
+	if (streaming) {
+		err = ads1299_stream_stop(dev);
 		if (err != 0) {
-			printk("Failed to set CH%dSET register\n", i + 1);
 			return err;
 		}
 	}
+#endif
+
+	// Registers can only be written outside of RDATAC
+	if (data->rdatac) {
+		err = send_command(dev, SDATAC);
+		if (err != 0) {
+			goto resume;
+		}
+	}
+
+	err = write_dirty_regs(dev);
+
+	// 섀도우에서 파생 상태 갱신 (SCLK는 다음 읽기부터 적용)
+	data->data_rate = data->regs[CONFIG1_REG] & 0x07;
+	data->channel_mask = mask;
+	select_sclk(dev);
+
+resume:
+	// 실패해도 연속 읽기와 스트림은 멈추기 전 상태로 되돌림
+	if (data->rdatac) {
+		resume_err = send_command(dev, RDATAC);
+		if (err == 0) {
+			err = resume_err;
+		}
+	}
+
+#ifdef CONFIG_TI_ADS1299_DPPI_STREAM
+	if (streaming) {
+		resume_err = ads1299_stream_start(dev, data->stream.frame_len,
+						  data->stream.cb,
+						  data->stream.user_data);
+		if (err == 0) {
+			err = resume_err;
+		}
+	}
+#endif
 
-	// Set BIASP
-	err = write_reg(dev, BIAS_SENSP_REG,
-			ADS1299_REG_BIAS_SENSP_BIASP2 |
-				ADS1299_REG_BIAS_SENSP_BIASP1);
 	if (err != 0) {
-		printk("Failed to set BIAS_SENSP register\n");
 		return err;
 	}
 
-	// Set BIASN
-	err = write_reg(dev, BIAS_SENSN_REG, ADS1299_REG_BIAS_SENSN_BIASN1);
+	if (!data->rdatac) {
+		return 0;
+	}
+
+	window_us = k_cyc_to_us_ceil32(k_cycle_get_32() - start_cyc);
+
+	return DIV_ROUND_UP((uint64_t)window_us * sps, USEC_PER_SEC);
+}
+
+static int init(const struct device *dev)
+{
+	int err;
+	uint32_t start_cyc = k_cycle_get_32();
+
+	const struct ti_ads1299_config *ads1299_config = dev->config;
+	struct ads1299_data *data = dev->data;
+#ifdef CONFIG_TI_ADS1299_DPPI_STREAM
+	data->dev = dev;
+#endif
+	spi_configs_init(dev);
+
+	err = spi_is_ready_dt(&ads1299_config->spi);
+	if (!err) {
+		printk("Error: SPI device is not ready, err: %d\n", err);
+		return err;
+	}
+
+#ifdef CONFIG_TI_ADS1299_TIMESTAMP
+	err = ads1299_ts_init();
 	if (err != 0) {
-		printk("Failed to set BIAS_SENSN register\n");
+		printk("Failed to start DRDY timestamp timer, err: %d\n", err);
 		return err;
 	}
+#endif
 
-	// Lead-Off dc
-	err = write_reg(dev, LOFF_REG,
-			ADS1299_REG_LOFF_95_PERCENT |
-				ADS1299_REG_LOFF_DC_LEAD_OFF);
+	// See Detail ADS1299 Data Sheet(Figure 67. Initial Flow at Power-Up)
+	// 1. Send SDATAC command
+	err = send_command(dev, SDATAC);
 	if (err != 0) {
-		printk("Failed to set LOFF register\n");
+		printk("Failed to send SDATAC command, err: %d\n", err);
 		return err;
 	}
 
-	err = write_reg(dev, CONFIG4_REG,
-			ADS1299_REG_CONFIG4_CONTINUOUS_CONVERSION_MODE |
-				ADS1299_REG_CONFIG4_LEAD_OFF_ENABLED);
+	// 2. CONFIG1 .. LOFF_FLIP in one WREG burst
+	uint8_t config[LOFF_FLIP_REG - CONFIG1_REG + 1] = {
+		// CONFIG1: DR from CONFIG_TI_ADS1299_DATA_RATE_SPS
+		[CONFIG1_REG - CONFIG1_REG] =
+			config1_value(dev, ADS1299_DR_CODE),
+		// CONFIG2: Test signal
+		[CONFIG2_REG - CONFIG1_REG] =
+			ADS1299_REG_CONFIG2_RESERVED_VALUE,
+		// CONFIG3: Enable internal reference buffer, BIASREF_INT=1
+		[CONFIG3_REG - CONFIG1_REG] =
+			ADS1299_REG_CONFIG3_REFBUF_ENABLED |
+			ADS1299_REG_CONFIG3_RESERVED_VALUE |
+			ADS1299_REG_CONFIG3_BIASBUF_ENABLED |
+			ADS1299_REG_CONFIG3_BIASREF_INT,
+		// Lead-Off dc
+		[LOFF_REG - CONFIG1_REG] = ADS1299_REG_LOFF_95_PERCENT |
+					   ADS1299_REG_LOFF_DC_LEAD_OFF,
+		// BIASN
+		[BIAS_SENSN_REG - CONFIG1_REG] = ADS1299_REG_BIAS_SENSN_BIASN1,
+		// Lead-off sensing follows the mask
+		[LOFF_SENSP_REG - CONFIG1_REG] = CONFIG_TI_ADS1299_CHANNEL_MASK,
+		[LOFF_SENSN_REG - CONFIG1_REG] = CONFIG_TI_ADS1299_CHANNEL_MASK,
+	};
+
+	// All Channels and BIASP follow the mask
+	channel_regs(CONFIG_TI_ADS1299_CHANNEL_MASK, ADS1299_CHNSET_DEFAULT,
+		     &config[CH1SET_REG - CONFIG1_REG]);
+
+	err = write_regs(dev, CONFIG1_REG, config, sizeof(config));
 	if (err != 0) {
-		printk("Failed to set CONFIG4 register\n");
+		printk("Failed to write configuration registers\n");
 		return err;
 	}
 
-	err = write_reg(dev, LOFF_SENSP_REG,
-			ADS1299_REG_LOFF_SENSP_LOFFP2 |
-				ADS1299_REG_LOFF_SENSP_LOFFP1);
+	// 3. GPIO .. CONFIG4: all pins driven-low outputs, continuous mode
+	uint8_t config_hi[] = {
+		[GPIO_REG - GPIO_REG] = ADS1299_REG_GPIO_GPIOC4_OUTPUT |
+					ADS1299_REG_GPIO_GPIOD4_LOW |
+					ADS1299_REG_GPIO_GPIOC3_OUTPUT |
+					ADS1299_REG_GPIO_GPIOD3_LOW |
+					ADS1299_REG_GPIO_GPIOC2_OUTPUT |
+					ADS1299_REG_GPIO_GPIOD2_LOW |
+					ADS1299_REG_GPIO_GPIOC1_OUTPUT |
+					ADS1299_REG_GPIO_GPIOD1_LOW,
+		[MISC1_REG - GPIO_REG] = 0,
+		[MISC2_REG - GPIO_REG] = 0,
+		[CONFIG4_REG - GPIO_REG] =
+			ADS1299_REG_CONFIG4_CONTINUOUS_CONVERSION_MODE |
+			ADS1299_REG_CONFIG4_LEAD_OFF_ENABLED,
+	};
+
+	err = write_regs(dev, GPIO_REG, config_hi, sizeof(config_hi));
 	if (err != 0) {
-		printk("Failed to set LOFF_SENSP register\n");
+		printk("Failed to write GPIO..CONFIG4 registers\n");
 		return err;
 	}
 
-	err = write_reg(dev, LOFF_SENSN_REG,
-			ADS1299_REG_LOFF_SENSN_LOFFN2 |
-				ADS1299_REG_LOFF_SENSN_LOFFN1);
+	// 5. Seed the shadow register map, ID and lead-off status included
+	err = read_regs(dev, ID_REG, data->regs, ADS1299_NUM_REGS);
 	if (err != 0) {
-		printk("Failed to set LOFF_SENSN register\n");
+		printk("Failed to read back registers\n");
 		return err;
 	}
 
+	data->chip_id = data->regs[ID_REG];
+	data->data_rate = ADS1299_DR_CODE;
+	data->channel_mask = CONFIG_TI_ADS1299_CHANNEL_MASK;
+	data->chnset = ADS1299_CHNSET_DEFAULT;
+	select_sclk(dev);
+
+	// 4. The reference buffer settles while the rest of the system boots,
+	//    START waits for whatever is left of it
+	data->ref_ready = k_uptime_get() + CONFIG_TI_ADS1299_REF_SETTLE_MS;
+
+	if (ads1299_config->num_devices > 1) {
+		printk("ADS1299 daisy chain of %d devices, %d byte frames\n",
+		       ads1299_config->num_devices,
+		       ADS1299_FRAME_LEN(ads1299_config->num_devices));
+	}
+
+	printk("ADS1299 configured in %u us\n",
+	       k_cyc_to_us_floor32(k_cycle_get_32() - start_cyc));
 	printk("---------- ADS1299 initial configuration completed successfully ----------\n");
 
 	return 0;
@@ -317,168 +603,260 @@ static void ads1299_config_print(const struct device *dev)
 
 	printk("ADS1299 Settings:\n");
 
+	// 섀도우 레지스터 맵에서 출력 (RDATAC 중에도 가능)
+	const struct ads1299_data *data = dev->data;
+	const uint8_t *regs = data->regs;
 	uint8_t reg_value;
-	// ID 레지스터 읽기
-	int err = read_reg(dev, ID_REG, &reg_value);
-	if (err == 0) {
-		printk("ID (0x00): 0x%02X\n", reg_value);
-		printk("  - Device: ADS%d\n",
-		       (reg_value & 0x07) == 0 ? 1299 : 1298);
-	}
-	k_msleep(DELAY_PARAM);
 
-	// CONFIG1 레지스터 읽기
-	err = read_reg(dev, CONFIG1_REG, &reg_value);
-	if (err == 0) {
-		printk("CONFIG1 (0x01): 0x%X\n", reg_value);
-		printk("  - Daisy-chain mode: %s\n",
-		       (reg_value & 0x40) ? "Enabled" : "Disabled");
-		printk("  - CLK output: %s\n",
-		       (reg_value & 0x20) ? "Enabled" : "Disabled");
-		printk("  - Data rate: %d SPS\n", 16000 >> (reg_value & 0x07));
+	// ID
+	reg_value = regs[ID_REG];
+	printk("ID (0x00): 0x%02X\n", reg_value);
+	printk("  - Device: ADS%d\n",
+	       (reg_value & 0x07) == 0 ? 1299 : 1298);
+
+	// CONFIG1
+	reg_value = regs[CONFIG1_REG];
+	printk("CONFIG1 (0x01): 0x%X\n", reg_value);
+	printk("  - Daisy-chain mode: %s\n",
+	       (reg_value & 0x40) ? "Disabled" : "Enabled");
+	printk("  - CLK output: %s\n",
+	       (reg_value & 0x20) ? "Enabled" : "Disabled");
+	printk("  - Data rate: %d SPS\n", 16000 >> (reg_value & 0x07));
+
+	// CONFIG2
+	reg_value = regs[CONFIG2_REG];
+	printk("CONFIG2 (0x02): 0x%X\n", reg_value);
+	printk("  - Test signal: %s\n",
+	       (reg_value & 0x10) ? "Enabled" : "Disabled");
+
+	// CONFIG3
+	reg_value = regs[CONFIG3_REG];
+	printk("CONFIG3 (0x03): 0x%02X\n", reg_value);
+	printk("  - Internal reference buffer: %s\n",
+	       (reg_value & 0x80) ? "Enabled" : "Disabled");
+	printk("  - Bias measurement: %s\n",
+	       (reg_value & 0x10) ? "Enabled" : "Disabled");
+	printk("  - Bias reference: %s\n",
+	       (reg_value & 0x08) ? "Internal" : "External");
+	printk("  - Bias buffer power: %s\n",
+	       (reg_value & 0x04) ? "Enabled" : "Disabled");
+	printk("  - Bias sense function: %s\n",
+	       (reg_value & 0x02) ? "Enabled" : "Disabled");
+	printk("  - Bias lead-off status: %s\n",
+	       (reg_value & 0x01) ? "Not connected" : "Connected");
+
+	// 채널 설정
+	for (int i = 0; i < ADS1299_NUM_CHANNELS; i++) {
+		reg_value = regs[CH1SET_REG + i];
+		printk("CH%dSET (0x%02X): 0x%02X\n", i + 1,
+		       CH1SET_REG + i, reg_value);
+		printk("  - Channel power: %s\n",
+		       (reg_value & 0x80) ? "Power-down" : "Normal");
+		printk("  - Gain: %s\n",
+		       gain_to_string((reg_value & 0x70) >> 4));
+		printk("  - SRB2 connection: %s\n",
+		       (reg_value & 0x08) ? "Closed" : "Open");
+		printk("  - Input Multiplexer: %s\n",
+		       mux_to_string(reg_value & 0x07));
 	}
-	k_msleep(DELAY_PARAM);
 
-	// CONFIG2 레지스터 읽기
-	err = read_reg(dev, CONFIG2_REG, &reg_value);
-	if (err == 0) {
-		printk("CONFIG2 (0x02): 0x%X\n", reg_value);
-		printk("  - Test signal: %s\n",
-		       (reg_value & 0x10) ? "Enabled" : "Disabled");
+	// BIAS_SENSP
+	reg_value = regs[BIAS_SENSP_REG];
+	printk("BIAS_SENSP (0x0D): 0x%02X\n", reg_value);
+	for (int i = 0; i < ADS1299_NUM_CHANNELS; i++) {
+		printk("  - Channel %d bias: %s\n", i + 1,
+		       (reg_value & (1 << i)) ? "Enabled" : "Disabled");
 	}
-	k_msleep(DELAY_PARAM);
 
-	// CONFIG3 레지스터 읽기
-	err = read_reg(dev, CONFIG3_REG, &reg_value);
-	if (err == 0) {
-		printk("CONFIG3 (0x03): 0x%02X\n", reg_value);
-		printk("  - Internal reference buffer: %s\n",
-		       (reg_value & 0x80) ? "Enabled" : "Disabled");
-		printk("  - Bias measurement: %s\n",
-		       (reg_value & 0x10) ? "Enabled" : "Disabled");
-		printk("  - Bias reference: %s\n",
-		       (reg_value & 0x08) ? "Internal" : "External");
-		printk("  - Bias buffer power: %s\n",
-		       (reg_value & 0x04) ? "Enabled" : "Disabled");
-		printk("  - Bias sense function: %s\n",
-		       (reg_value & 0x02) ? "Enabled" : "Disabled");
-		printk("  - Bias lead-off status: %s\n",
-		       (reg_value & 0x01) ? "Not connected" : "Connected");
-	}
-	k_msleep(DELAY_PARAM);
-
-	// 채널 설정 읽기
-	for (int i = 0; i < 4; i++) {
-		err = read_reg(dev, CH1SET_REG + i, &reg_value);
-		if (err == 0) {
-			printk("CH%dSET (0x%02X): 0x%02X\n", i + 1,
-			       CH1SET_REG + i, reg_value);
-			printk("  - Channel power: %s\n",
-			       (reg_value & 0x80) ? "Power-down" : "Normal");
-			printk("  - Gain: %s\n",
-			       gain_to_string((reg_value & 0x70) >> 4));
-			printk("  - SRB2 connection: %s\n",
-			       (reg_value & 0x08) ? "Closed" : "Open");
-			printk("  - Input Multiplexer: %s\n",
-			       mux_to_string(reg_value & 0x07));
-		}
-		k_msleep(DELAY_PARAM);
+	// BIAS_SENSN
+	reg_value = regs[BIAS_SENSN_REG];
+	printk("BIAS_SENSN (0x0E): 0x%02X\n", reg_value);
+	for (int i = 0; i < ADS1299_NUM_CHANNELS; i++) {
+		printk("  - Channel %d bias: %s\n", i + 1,
+		       (reg_value & (1 << i)) ? "Enabled" : "Disabled");
 	}
 
-	// BIAS_SENSP 레지스터 읽기
-	err = read_reg(dev, BIAS_SENSP_REG, &reg_value);
-	if (err == 0) {
-		printk("BIAS_SENSP (0x0D): 0x%02X\n", reg_value);
-		for (int i = 0; i < 4; i++) {
-			printk("  - Channel %d bias: %s\n", i + 1,
-			       (reg_value & (1 << i)) ? "Enabled" : "Disabled");
-			k_msleep(DELAY_PARAM);
-		}
+	// LOFF_SENSP
+	reg_value = regs[LOFF_SENSP_REG];
+	printk("LOFF_SENSP (0x0F): 0x%02X\n", reg_value);
+	for (int i = 0; i < ADS1299_NUM_CHANNELS; i++) {
+		printk("  - Channel %d lead-off detection P: %s\n",
+		       i + 1,
+		       (reg_value & (1 << i)) ? "Enabled" : "Disabled");
 	}
 
-	// BIAS_SENSN 레지스터 읽기
-	err = read_reg(dev, BIAS_SENSN_REG, &reg_value);
-	if (err == 0) {
-		printk("BIAS_SENSN (0x0E): 0x%02X\n", reg_value);
-		for (int i = 0; i < 4; i++) {
-			printk("  - Channel %d bias: %s\n", i + 1,
-			       (reg_value & (1 << i)) ? "Enabled" : "Disabled");
-			k_msleep(DELAY_PARAM);
-		}
+	// LOFF_SENSN
+	reg_value = regs[LOFF_SENSN_REG];
+	printk("LOFF_SENSN (0x10): 0x%02X\n", reg_value);
+	for (int i = 0; i < ADS1299_NUM_CHANNELS; i++) {
+		printk("  - Channel %d lead-off detection N: %s\n",
+		       i + 1,
+		       (reg_value & (1 << i)) ? "Enabled" : "Disabled");
 	}
 
-	// LOFF_SENSP 레지스터 읽기
-	err = read_reg(dev, LOFF_SENSP_REG, &reg_value);
-	if (err == 0) {
-		printk("LOFF_SENSP (0x0F): 0x%02X\n", reg_value);
-		for (int i = 0; i < 4; i++) {
-			printk("  - Channel %d lead-off detection P: %s\n",
-			       i + 1,
-			       (reg_value & (1 << i)) ? "Enabled" : "Disabled");
-			k_msleep(DELAY_PARAM);
-		}
+	// GPIO
+	reg_value = regs[GPIO_REG];
+	printk("GPIO (0x14): 0x%02X\n", reg_value);
+	printk("  - GPIO1 direction: %s\n",
+	       (reg_value & 0x01) ? "Input" : "Output");
+	printk("  - GPIO2 direction: %s\n",
+	       (reg_value & 0x02) ? "Input" : "Output");
+	printk("  - GPIO3 direction: %s\n",
+	       (reg_value & 0x04) ? "Input" : "Output");
+	printk("  - GPIO4 direction: %s\n",
+	       (reg_value & 0x08) ? "Input" : "Output");
+
+	// CONFIG4
+	reg_value = regs[CONFIG4_REG];
+	printk("CONFIG4 (0x17): 0x%02X\n", reg_value);
+	printk("  - Single Shot: %s\n", (reg_value & 0x08) ?
+						"Single-shot mode" :
+						"Continuous mode");
+	printk("  - Lead-off comparator power-down: %s\n",
+	       (reg_value & 0x02) ? "Enabled" : "Disabled");
+}
+
+/*
+ * Reads are served from the shadow. Only the lead-off status registers
+ * change on their own; they are refreshed from the chip when it is not in
+ * RDATAC (in RDATAC the same bits arrive in every frame's status word).
+ */
+static int ads1299_read_regs(const struct device *dev, uint8_t reg,
+			     uint8_t *values, size_t count)
+{
+	struct ads1299_data *data = dev->data;
+	int err;
+
+	if (count == 0 || reg + count > ADS1299_NUM_REGS) {
+		return -EINVAL;
 	}
 
-	// LOFF_SENSN 레지스터 읽기
-	err = read_reg(dev, LOFF_SENSN_REG, &reg_value);
-	if (err == 0) {
-		printk("LOFF_SENSN (0x10): 0x%02X\n", reg_value);
-		for (int i = 0; i < 4; i++) {
-			printk("  - Channel %d lead-off detection N: %s\n",
-			       i + 1,
-			       (reg_value & (1 << i)) ? "Enabled" : "Disabled");
-			k_msleep(DELAY_PARAM);
+	if (!data->rdatac &&
+	    (GENMASK(reg + count - 1, reg) &
+	     (BIT(LOFF_STATP_REG) | BIT(LOFF_STATN_REG)))) {
+		uint8_t stat[2];
+
+		err = read_regs(dev, LOFF_STATP_REG, stat, sizeof(stat));
+		if (err != 0) {
+			return err;
 		}
 	}
 
-	// GPIO 레지스터 읽기
-	err = read_reg(dev, GPIO_REG, &reg_value);
-	if (err == 0) {
-		printk("GPIO (0x14): 0x%02X\n", reg_value);
-		printk("  - GPIO1 direction: %s\n",
-		       (reg_value & 0x01) ? "Input" : "Output");
-		printk("  - GPIO2 direction: %s\n",
-		       (reg_value & 0x02) ? "Input" : "Output");
-		printk("  - GPIO3 direction: %s\n",
-		       (reg_value & 0x04) ? "Input" : "Output");
-		printk("  - GPIO4 direction: %s\n",
-		       (reg_value & 0x08) ? "Input" : "Output");
-	}
-	k_msleep(DELAY_PARAM);
-
-	// CONFIG4 레지스터 읽기
-	err = read_reg(dev, CONFIG4_REG, &reg_value);
-	if (err == 0) {
-		printk("CONFIG4 (0x17): 0x%02X\n", reg_value);
-		printk("  - Single Shot: %s\n", (reg_value & 0x08) ?
-							"Single-shot mode" :
-							"Continuous mode");
-		printk("  - Lead-off comparator power-down: %s\n",
-		       (reg_value & 0x02) ? "Enabled" : "Disabled");
+	memcpy(values, &data->regs[reg], count);
+
+	return 0;
+}
+
+static int ads1299_write_regs(const struct device *dev, uint8_t reg,
+			      const uint8_t *values, size_t count)
+{
+	int err;
+
+	err = stage_regs(dev, reg, values, count);
+	if (err != 0) {
+		return err;
 	}
+
+	err = apply_regs(dev);
+
+	return err < 0 ? err : 0;
 }
 
 static int ads1299_read_reg(const struct device *dev, uint8_t reg,
 			    uint8_t *value)
 {
-	printk("Read to a given register of ADS1299\n");
-
-	return read_reg(dev, reg, value);
+	return ads1299_read_regs(dev, reg, value, 1);
 }
 
 static int ads1299_write_reg(const struct device *dev, uint8_t reg,
 			     uint8_t value)
 {
-	printk("Write to a given register of ADS1299\n");
+	return ads1299_write_regs(dev, reg, &value, 1);
+}
+
+static int ads1299_stage_reg(const struct device *dev, uint8_t reg,
+			     uint8_t mask, uint8_t value)
+{
+	const struct ads1299_data *data = dev->data;
+	uint8_t staged;
+
+	if (reg >= ADS1299_NUM_REGS) {
+		return -EINVAL;
+	}
 
-	return write_reg(dev, reg, value);
+	staged = (data->regs[reg] & ~mask) | (value & mask);
+
+	return stage_regs(dev, reg, &staged, 1);
+}
+
+static int ads1299_apply(const struct device *dev)
+{
+	return apply_regs(dev);
 }
 
 static int ads1299_command(const struct device *dev, uint8_t cmd)
 {
+	struct ads1299_data *data = dev->data;
+	int err;
+
 	printk("Send command to ADS1299\n");
 
-	return send_command(dev, cmd);
+	// 기준 전압 버퍼가 안정될 때까지 변환 시작을 미룸
+	if (cmd == START) {
+		int64_t remaining = data->ref_ready - k_uptime_get();
+
+		if (remaining > 0) {
+			k_msleep(remaining);
+		}
+	}
+
+	err = send_command(dev, cmd);
+	if (err == 0 && (cmd == RDATAC || cmd == SDATAC)) {
+		data->rdatac = (cmd == RDATAC);
+	}
+
+	return err;
+}
+
+static int ads1299_set_channels(const struct device *dev, uint8_t mask,
+				uint8_t chnset)
+{
+	struct ads1299_data *data = dev->data;
+	uint8_t regs[ADS1299_NUM_CHANNELS + 1];
+	uint8_t loff[] = { mask, mask };
+	int err;
+
+	// CHnSET + BIAS_SENSP, LOFF_SENSP/N가 마스크를 따름
+	channel_regs(mask, chnset, regs);
+
+	err = stage_regs(dev, CH1SET_REG, regs, sizeof(regs));
+	if (err == 0) {
+		err = stage_regs(dev, LOFF_SENSP_REG, loff, sizeof(loff));
+	}
+	if (err == 0) {
+		err = apply_regs(dev);
+	}
+	if (err < 0) {
+		return err;
+	}
+
+	data->chnset = chnset;
+
+	return 0;
+}
+
+static uint8_t ads1299_get_channels(const struct device *dev)
+{
+	const struct ads1299_data *data = dev->data;
+
+	return data->channel_mask;
+}
+
+static uint32_t ads1299_get_data_rate(const struct device *dev)
+{
+	const struct ads1299_data *data = dev->data;
+
+	return ads1299_sps(data->data_rate);
 }
 
 static int ads1299_read_data(const struct device *dev, uint8_t *data,
@@ -488,26 +866,75 @@ static int ads1299_read_data(const struct device *dev, uint8_t *data,
 	struct spi_buf_set rx = { .buffers = &rx_buf, .count = 1 };
 
 	const struct ti_ads1299_config *ads1299_config = dev->config;
+	const struct ads1299_data *drv_data = dev->data;
 
-	return spi_read_dt(&ads1299_config->spi, &rx);
+	return spi_read(ads1299_config->spi.bus, drv_data->data_spi, &rx);
 }
 
 static const struct ti_ads1299_driver_api ti_ads1299_api_funcs = {
 	.config = ads1299_config_print,
 	.read_reg = ads1299_read_reg,
 	.write_reg = ads1299_write_reg,
+	.read_regs = ads1299_read_regs,
+	.write_regs = ads1299_write_regs,
+	.stage_reg = ads1299_stage_reg,
+	.apply = ads1299_apply,
 	.command = ads1299_command,
 	.read_data = ads1299_read_data,
+	.set_channels = ads1299_set_channels,
+	.get_channels = ads1299_get_channels,
+	.get_data_rate = ads1299_get_data_rate,
+#ifdef CONFIG_TI_ADS1299_DPPI_STREAM
+	.stream_start = ads1299_stream_start,
+	.stream_stop = ads1299_stream_stop,
+#endif
+#ifdef CONFIG_TI_ADS1299_TIMESTAMP
+	.timestamp_enable = ads1299_ts_enable,
+	.timestamp_get = ads1299_ts_get,
+	.timestamp_now = ads1299_ts_now,
+#endif
 };
 
+#define ADS1299_NUM_DEVICES(inst) DT_INST_PROP(inst, daisy_chain_length)
+
+#ifdef ADS1299_NRFX_DRDY
+/* DRDY pin number for the GPIOTE -> DPPI links. */
+#define ADS1299_CONFIG_DRDY(inst) \
+	.drdy_pin = NRF_DT_GPIOS_TO_PSEL(DT_DRV_INST(inst), drdy_gpios),
+#else
+#define ADS1299_CONFIG_DRDY(inst)
+#endif
+
+#ifdef CONFIG_TI_ADS1299_DPPI_STREAM
+/* Stream buffer holding two blocks of this instance's widest frame. */
+#define ADS1299_STREAM_BUF_DEFINE(inst)                         \
+	static uint8_t ads1299_stream_buf_##inst                \
+		[2 * CONFIG_TI_ADS1299_STREAM_FRAMES *          \
+		 ADS1299_FRAME_LEN(ADS1299_NUM_DEVICES(inst))];
+
+/* Peripheral and pin numbers needed to wire the DRDY -> SPIM DPPI chain. */
+#define ADS1299_CONFIG_STREAM(inst)                                        \
+	.stream_buf = ads1299_stream_buf_##inst,                           \
+	.spim = (NRF_SPIM_Type *)DT_REG_ADDR(DT_INST_BUS(inst)),           \
+	.cs_pin = NRF_DT_GPIOS_TO_PSEL_BY_IDX(DT_INST_BUS(inst), cs_gpios, \
+					      DT_INST_REG_ADDR(inst)),
+#else
+#define ADS1299_STREAM_BUF_DEFINE(inst)
+#define ADS1299_CONFIG_STREAM(inst)
+#endif
+
 /* Initializes a struct ads1299_config for an instance on a SPI bus. */
 #define ADS1299_CONFIG_SPI(inst)                                             \
 	{                                                                    \
 		.spi = SPI_DT_SPEC_INST_GET(inst, ADS1299_SPI_OPERATION, 0), \
+		.num_devices = ADS1299_NUM_DEVICES(inst),                    \
+		ADS1299_CONFIG_DRDY(inst)                                    \
+		ADS1299_CONFIG_STREAM(inst)                                  \
 	}
 
 /* STEP 5.1 - Define a device driver instance */
 #define TI_ADS1299_DEFINE(inst)                                          \
+	ADS1299_STREAM_BUF_DEFINE(inst)                                  \
 	static struct ads1299_data ads1299_data_##inst;                  \
 	static const struct ti_ads1299_config ti_ads1299_config_##inst = \
 		ADS1299_CONFIG_SPI(inst);                                \
@@ -10,27 +10,89 @@
 extern "C" {
 #endif
 
+#include <errno.h>
 #include <zephyr/device.h>
 
 #define DT_DRV_COMPAT ti_ads1299
 
+/* Rate of the DRDY timestamps, see ti_ads1299_timestamp_get() */
+#define TI_ADS1299_TIMESTAMP_HZ 16000000U
+
 /* Typedef declaration of the function pointers */
 typedef void (*ti_ads1299_api_config_t)(const struct device *dev);
 typedef int (*ti_ads1299_api_read_reg_t)(const struct device *dev, uint8_t reg,
 					 uint8_t *value);
 typedef int (*ti_ads1299_api_write_reg_t)(const struct device *dev, uint8_t reg,
 					  uint8_t value);
+typedef int (*ti_ads1299_api_read_regs_t)(const struct device *dev,
+					  uint8_t reg, uint8_t *values,
+					  size_t count);
+typedef int (*ti_ads1299_api_write_regs_t)(const struct device *dev,
+					   uint8_t reg, const uint8_t *values,
+					   size_t count);
+typedef int (*ti_ads1299_api_stage_reg_t)(const struct device *dev,
+					  uint8_t reg, uint8_t mask,
+					  uint8_t value);
+typedef int (*ti_ads1299_api_apply_t)(const struct device *dev);
 typedef int (*ti_ads1299_api_command_t)(const struct device *dev, uint8_t cmd);
 typedef int (*ti_ads1299_api_read_data_t)(const struct device *dev,
 					  uint8_t *data, size_t len);
+typedef int (*ti_ads1299_api_set_channels_t)(const struct device *dev,
+					     uint8_t mask, uint8_t chnset);
+typedef uint8_t (*ti_ads1299_api_get_channels_t)(const struct device *dev);
+typedef uint32_t (*ti_ads1299_api_get_data_rate_t)(const struct device *dev);
+
+/**
+ * @brief Callback for a block of frames captured by the DPPI stream.
+ *
+ * Runs in interrupt context once every CONFIG_TI_ADS1299_STREAM_FRAMES
+ * frames. @p frames stays valid until the same half of the DMA list is
+ * refilled, i.e. for another CONFIG_TI_ADS1299_STREAM_FRAMES DRDY periods.
+ * ti_ads1299_stream_stop() also calls it from the caller's context with the
+ * frames of the block that was still filling.
+ *
+ * @p timestamps holds the DRDY time of each frame in
+ * TI_ADS1299_TIMESTAMP_HZ ticks (see ti_ads1299_timestamp_get()), or is NULL
+ * without CONFIG_TI_ADS1299_TIMESTAMP. The newest one is captured, the
+ * others are interpolated from the measured DRDY period.
+ *
+ * @p drdy is the number of DRDY edges counted in hardware since the previous
+ * block, up to the last frame of this one. It exceeds @p count by the
+ * conversions that were never read, e.g. while the list was being rewound;
+ * those are assumed to precede the frames of this block.
+ */
+typedef void (*ti_ads1299_stream_cb_t)(const struct device *dev,
+				       const uint8_t *frames,
+				       const uint32_t *timestamps,
+				       size_t count, uint32_t drdy,
+				       void *user_data);
+typedef int (*ti_ads1299_api_stream_start_t)(const struct device *dev,
+					     size_t frame_len,
+					     ti_ads1299_stream_cb_t cb,
+					     void *user_data);
+typedef int (*ti_ads1299_api_stream_stop_t)(const struct device *dev);
+typedef int (*ti_ads1299_api_timestamp_enable_t)(const struct device *dev);
+typedef uint32_t (*ti_ads1299_api_timestamp_get_t)(const struct device *dev);
 
 /* Define a struct to have a member for each typedef you defined in Part 1 */
 struct ti_ads1299_driver_api {
 	ti_ads1299_api_config_t config;
 	ti_ads1299_api_read_reg_t read_reg;
 	ti_ads1299_api_write_reg_t write_reg;
+	ti_ads1299_api_read_regs_t read_regs;
+	ti_ads1299_api_write_regs_t write_regs;
+	ti_ads1299_api_stage_reg_t stage_reg;
+	ti_ads1299_api_apply_t apply;
 	ti_ads1299_api_command_t command;
 	ti_ads1299_api_read_data_t read_data;
+	ti_ads1299_api_set_channels_t set_channels;
+	ti_ads1299_api_get_channels_t get_channels;
+	ti_ads1299_api_get_data_rate_t get_data_rate;
+	ti_ads1299_api_stream_start_t stream_start;
+	ti_ads1299_api_stream_stop_t stream_stop;
+	ti_ads1299_api_timestamp_enable_t timestamp_enable;
+	ti_ads1299_api_timestamp_get_t timestamp_get;
+	ti_ads1299_api_timestamp_get_t timestamp_now;
 };
 
 /* Implement the API to be exposed to the application with type and arguments matching the typedef */
@@ -45,6 +107,13 @@ static inline void z_impl_ti_ads1299_config(const struct device *dev)
 	api->config(dev);
 }
 
+/**
+ * @brief Read a register from the driver's shadow copy of the register map.
+ *
+ * No bus access except for LOFF_STATP/LOFF_STATN, which are refreshed from
+ * the chip when it is not in RDATAC mode. In a daisy chain the shadow holds
+ * the first chip's registers; writes and commands always reach every chip.
+ */
 __syscall int ti_ads1299_read_reg(const struct device *dev, uint8_t reg,
 				  uint8_t *value);
 static inline int z_impl_ti_ads1299_read_reg(const struct device *dev,
@@ -57,6 +126,7 @@ static inline int z_impl_ti_ads1299_read_reg(const struct device *dev,
 	return api->read_reg(dev, reg, value);
 }
 
+/** @brief Stage a register and apply it, see ti_ads1299_apply(). */
 __syscall int ti_ads1299_write_reg(const struct device *dev, uint8_t reg,
 				   uint8_t value);
 static inline int z_impl_ti_ads1299_write_reg(const struct device *dev,
@@ -69,6 +139,100 @@ static inline int z_impl_ti_ads1299_write_reg(const struct device *dev,
 	return api->write_reg(dev, reg, value);
 }
 
+/**
+ * @brief Read @p count consecutive registers starting at @p reg, served from
+ * the shadow like ti_ads1299_read_reg().
+ *
+ * @return 0 on success, -EINVAL if the range runs past CONFIG4 (0x17).
+ */
+__syscall int ti_ads1299_read_regs(const struct device *dev, uint8_t reg,
+				   uint8_t *values, size_t count);
+static inline int z_impl_ti_ads1299_read_regs(const struct device *dev,
+					      uint8_t reg, uint8_t *values,
+					      size_t count)
+{
+	const struct ti_ads1299_driver_api *api = dev->api;
+
+	__ASSERT(api->read_regs, "Callback pointer should not be NULL");
+
+	return api->read_regs(dev, reg, values, count);
+}
+
+/**
+ * @brief Stage @p count consecutive registers starting at @p reg and apply
+ * them, see ti_ads1299_apply().
+ *
+ * Registers that already hold the requested value are not rewritten. Bytes
+ * are clocked slower than tSDECODE so bursts need no extra spacing.
+ *
+ * @return 0 on success, -EINVAL if the range runs past CONFIG4 (0x17) or
+ *         covers a read-only register, or an error from the apply step.
+ */
+__syscall int ti_ads1299_write_regs(const struct device *dev, uint8_t reg,
+				    const uint8_t *values, size_t count);
+static inline int z_impl_ti_ads1299_write_regs(const struct device *dev,
+					       uint8_t reg,
+					       const uint8_t *values,
+					       size_t count)
+{
+	const struct ti_ads1299_driver_api *api = dev->api;
+
+	__ASSERT(api->write_regs, "Callback pointer should not be NULL");
+
+	return api->write_regs(dev, reg, values, count);
+}
+
+/**
+ * @brief Change bits of a register in the shadow without touching the bus.
+ *
+ * Bits set in @p mask take their value from @p value. The register is marked
+ * dirty if its value changes, and written by the next ti_ads1299_apply().
+ * Use it to prepare several changes (e.g. gain and mux of a few channels)
+ * that should reach the chip in a single reconfiguration window.
+ *
+ * @return 0 on success, -EINVAL for an unknown or read-only register.
+ */
+__syscall int ti_ads1299_stage_reg(const struct device *dev, uint8_t reg,
+				   uint8_t mask, uint8_t value);
+static inline int z_impl_ti_ads1299_stage_reg(const struct device *dev,
+					      uint8_t reg, uint8_t mask,
+					      uint8_t value)
+{
+	const struct ti_ads1299_driver_api *api = dev->api;
+
+	__ASSERT(api->stage_reg, "Callback pointer should not be NULL");
+
+	return api->stage_reg(dev, reg, mask, value);
+}
+
+/**
+ * @brief Write all staged registers to the chip.
+ *
+ * In RDATAC mode the device is stopped with SDATAC, the dirty registers are
+ * sent in as few WREG bursts as possible and RDATAC is resumed. A running
+ * DPPI stream is paused around that window and restarted with the same
+ * callback. Changes that would alter the stream's frame length (powering
+ * channels above the highest active one, or down to a lower one) must be
+ * made with the stream stopped.
+ *
+ * @return Number of samples skipped during the window (0 outside RDATAC),
+ *         -EBUSY if the change needs the stream stopped, or another
+ *         negative errno.
+ */
+__syscall int ti_ads1299_apply(const struct device *dev);
+static inline int z_impl_ti_ads1299_apply(const struct device *dev)
+{
+	const struct ti_ads1299_driver_api *api = dev->api;
+
+	__ASSERT(api->apply, "Callback pointer should not be NULL");
+
+	return api->apply(dev);
+}
+
+/**
+ * @brief Send an opcode. START waits until the internal reference has
+ * settled (CONFIG_TI_ADS1299_REF_SETTLE_MS after init).
+ */
 __syscall int ti_ads1299_command(const struct device *dev, uint8_t cmd);
 static inline int z_impl_ti_ads1299_command(const struct device *dev,
 					    uint8_t cmd)
@@ -92,6 +256,155 @@ static inline int z_impl_ti_ads1299_read_data(const struct device *dev,
 	return api->read_data(dev, data, len);
 }
 
+/**
+ * @brief Power the channels in @p mask and power down (and short) the rest.
+ *
+ * Every enabled CHnSET register is written with @p chnset (gain, SRB2 and
+ * input mux bits), and lead-off/bias sensing follows the mask. The update is
+ * staged and applied like ti_ads1299_apply(), so only the registers that
+ * change are written.
+ * In a daisy chain the write reaches every chip, so all of them share the
+ * same mask.
+ *
+ * @param mask Bit n enables channel n + 1.
+ * @param chnset CHnSET value for enabled channels, the PD bit is ignored.
+ */
+__syscall int ti_ads1299_set_channels(const struct device *dev, uint8_t mask,
+				      uint8_t chnset);
+static inline int z_impl_ti_ads1299_set_channels(const struct device *dev,
+						 uint8_t mask, uint8_t chnset)
+{
+	const struct ti_ads1299_driver_api *api = dev->api;
+
+	__ASSERT(api->set_channels, "Callback pointer should not be NULL");
+
+	return api->set_channels(dev, mask, chnset);
+}
+
+/** @brief Mask of the channels currently powered. */
+__syscall uint8_t ti_ads1299_get_channels(const struct device *dev);
+static inline uint8_t z_impl_ti_ads1299_get_channels(const struct device *dev)
+{
+	const struct ti_ads1299_driver_api *api = dev->api;
+
+	__ASSERT(api->get_channels, "Callback pointer should not be NULL");
+
+	return api->get_channels(dev);
+}
+
+/** @brief Current output data rate in samples per second. */
+__syscall uint32_t ti_ads1299_get_data_rate(const struct device *dev);
+static inline uint32_t z_impl_ti_ads1299_get_data_rate(const struct device *dev)
+{
+	const struct ti_ads1299_driver_api *api = dev->api;
+
+	__ASSERT(api->get_data_rate, "Callback pointer should not be NULL");
+
+	return api->get_data_rate(dev);
+}
+
+/**
+ * @brief Start DRDY-triggered acquisition without CPU involvement per frame.
+ *
+ * The DRDY falling edge starts the SPIM transfer in hardware (GPIOTE ->
+ * DPPI -> SPIM) into a multi-frame EasyDMA list, and @p cb is only called
+ * once per block. The device must already be in RDATAC mode. The SPI bus
+ * stays locked to this device until ti_ads1299_stream_stop() is called.
+ *
+ * @return 0 on success, -ENOTSUP if CONFIG_TI_ADS1299_DPPI_STREAM is off.
+ */
+__syscall int ti_ads1299_stream_start(const struct device *dev,
+				      size_t frame_len,
+				      ti_ads1299_stream_cb_t cb,
+				      void *user_data);
+static inline int z_impl_ti_ads1299_stream_start(const struct device *dev,
+						 size_t frame_len,
+						 ti_ads1299_stream_cb_t cb,
+						 void *user_data)
+{
+	const struct ti_ads1299_driver_api *api = dev->api;
+
+	if (api->stream_start == NULL) {
+		return -ENOTSUP;
+	}
+
+	return api->stream_start(dev, frame_len, cb, user_data);
+}
+
+/**
+ * @brief Stop the DPPI stream and release the SPI bus.
+ *
+ * Frames of the partially filled block are passed to the stream callback
+ * before this returns.
+ */
+__syscall int ti_ads1299_stream_stop(const struct device *dev);
+static inline int z_impl_ti_ads1299_stream_stop(const struct device *dev)
+{
+	const struct ti_ads1299_driver_api *api = dev->api;
+
+	if (api->stream_stop == NULL) {
+		return -ENOTSUP;
+	}
+
+	return api->stream_stop(dev);
+}
+
+/**
+ * @brief Route DRDY edges to the timestamp counter for polled acquisition.
+ *
+ * Call once after the DRDY pin has been configured for edge interrupts. Not
+ * needed with the DPPI stream, which captures the edges itself.
+ *
+ * @return 0 on success, -ENOTSUP without CONFIG_TI_ADS1299_TIMESTAMP.
+ */
+__syscall int ti_ads1299_timestamp_enable(const struct device *dev);
+static inline int z_impl_ti_ads1299_timestamp_enable(const struct device *dev)
+{
+	const struct ti_ads1299_driver_api *api = dev->api;
+
+	if (api->timestamp_enable == NULL) {
+		return -ENOTSUP;
+	}
+
+	return api->timestamp_enable(dev);
+}
+
+/**
+ * @brief Time of the last DRDY falling edge.
+ *
+ * Captured in hardware over DPPI from a free-running counter at
+ * TI_ADS1299_TIMESTAMP_HZ, so it is not affected by interrupt or thread
+ * latency. The 32-bit value wraps after ~268 s; compare timestamps by
+ * difference. Returns 0 without CONFIG_TI_ADS1299_TIMESTAMP.
+ */
+__syscall uint32_t ti_ads1299_timestamp_get(const struct device *dev);
+static inline uint32_t z_impl_ti_ads1299_timestamp_get(const struct device *dev)
+{
+	const struct ti_ads1299_driver_api *api = dev->api;
+
+	if (api->timestamp_get == NULL) {
+		return 0;
+	}
+
+	return api->timestamp_get(dev);
+}
+
+/**
+ * @brief Current value of the timestamp counter, to relate frame timestamps
+ * to other events (IMU samples, transmission) or to measure latency.
+ */
+__syscall uint32_t ti_ads1299_timestamp_now(const struct device *dev);
+static inline uint32_t z_impl_ti_ads1299_timestamp_now(const struct device *dev)
+{
+	const struct ti_ads1299_driver_api *api = dev->api;
+
+	if (api->timestamp_now == NULL) {
+		return 0;
+	}
+
+	return api->timestamp_now(dev);
+}
+
 #ifdef __cplusplus
 }
 #endif
@@ -306,6 +619,11 @@ static inline int z_impl_ti_ads1299_read_data(const struct device *dev,
 
 /* CHnSET REGISTERS ******************************************************************************************************************************/
 
+/**
+ *  \brief Address of CH1SET, CHnSET is at ADS1299_REG_CH1SET + n - 1.
+ */
+#define ADS1299_REG_CH1SET 0x05
+
 /**
  *  \brief Bit mask definitions for CHnSET.PD (channel power-down).
  */
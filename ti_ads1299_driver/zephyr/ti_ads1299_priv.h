@@ -0,0 +1,158 @@
+/*
+ * Copyright (c) 2024 HHS
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#ifndef __TI_ADS1299_PRIV_H__
+#define __TI_ADS1299_PRIV_H__
+
+#include "ti_ads1299_driver_spi.h"
+
+#include <zephyr/device.h>
+#include <zephyr/drivers/spi.h>
+#if defined(CONFIG_TI_ADS1299_DPPI_STREAM) || \
+	defined(CONFIG_TI_ADS1299_TIMESTAMP)
+#include <soc.h>
+#define ADS1299_NRFX_DRDY 1
+
+/* GPIOTE instance owned by the core the driver runs on */
+#ifdef CONFIG_TRUSTED_EXECUTION_NONSECURE
+#define ADS1299_GPIOTE_IDX 1
+#else
+#define ADS1299_GPIOTE_IDX 0
+#endif
+#endif
+
+#define ADS1299_NUM_CHANNELS 8
+
+/* Register map size, ID (0x00) through CONFIG4 (0x17) */
+#define ADS1299_NUM_REGS 0x18
+
+/* Number of SCLK rates the sample reads can pick from */
+#define ADS1299_NUM_SCLK 5
+
+/* Output data rate in SPS for a CONFIG1.DR code at the 2.048 MHz clock */
+static inline uint32_t ads1299_sps(uint8_t dr)
+{
+	return 16000U >> dr;
+}
+
+/* Frame one chip shifts out: 24-bit status + 8 x 24-bit channels */
+#define ADS1299_DEVICE_FRAME_LEN (3 + ADS1299_NUM_CHANNELS * 3)
+
+/* Frame of a daisy chain of n chips read in one burst */
+#define ADS1299_FRAME_LEN(n) ((n) * ADS1299_DEVICE_FRAME_LEN)
+
+/*
+ * Bytes to clock per DRDY for a daisy chain of num_devices chips with the
+ * same channel mask. Upstream chips are shifted out whole, only the trailing
+ * disabled channels of the last one can be left in the chain.
+ */
+static inline size_t ads1299_frame_len(uint8_t num_devices, uint8_t mask)
+{
+	return ADS1299_FRAME_LEN(num_devices - 1) + 3 +
+	       3 * (32 - __builtin_clz(mask | 1));
+}
+
+#ifdef CONFIG_TI_ADS1299_DPPI_STREAM
+#include <hal/nrf_spim.h>
+#include <helpers/nrfx_gppi.h>
+
+/* State of the DRDY -> DPPI -> SPIM acquisition chain */
+struct ads1299_stream {
+	/* EasyDMA list, two halves of CONFIG_TI_ADS1299_STREAM_FRAMES each */
+	uint8_t *buf;
+#ifdef CONFIG_TI_ADS1299_TIMESTAMP
+	/* DRDY time of each frame in buf, see stream_ts_fill() */
+	uint32_t ts[2 * CONFIG_TI_ADS1299_STREAM_FRAMES];
+	/* DRDY time of the last frame delivered and the measured period */
+	uint32_t ts_last;
+	uint32_t ts_period;
+#endif
+	size_t frame_len;
+	ti_ads1299_stream_cb_t cb;
+	void *user_data;
+	/* Config carrying SPI_LOCK_ON, keeps the bus owned while streaming */
+	struct spi_config lock_cfg;
+	uint8_t drdy_ch;
+	uint8_t cs_ch;
+	/* DRDY edge -> EGU + edge count, never gated */
+	uint8_t ppi_drdy;
+	/* EGU -> CS low + SPIM START, gated by the group */
+	uint8_t ppi_start;
+	uint8_t ppi_end;
+	/* Half and end of the list -> capture of the DRDY edge count */
+	uint8_t ppi_half;
+	/* End of the list -> start channel off until the list is rewound */
+	uint8_t ppi_wrap;
+	/* DRDY edge count captured for the previous block */
+	uint32_t drdy_last;
+	nrfx_gppi_channel_group_t group;
+	uint8_t orc;
+	bool running;
+};
+#endif
+
+/* Data structure to store ADS1299 data */
+struct ads1299_data {
+	uint8_t chip_id;
+	/* Shadow of the register map */
+	uint8_t regs[ADS1299_NUM_REGS];
+	/* Bit n set when regs[n] is staged but not yet written to the chip */
+	uint32_t dirty;
+	/* Powered channels and the CHnSET value they were written with */
+	uint8_t channel_mask;
+	uint8_t chnset;
+	/* CONFIG1.DR code */
+	uint8_t data_rate;
+	/* Tracks RDATAC/SDATAC so reconfiguration can resume streaming */
+	bool rdatac;
+	/* Uptime (ms) at which the internal reference buffer has settled */
+	int64_t ref_ready;
+	/* Bus config for register access and opcodes */
+	struct spi_config reg_spi;
+	/* One bus config per SCLK rate, data_spi points at the one in use */
+	struct spi_config data_spi_cfgs[ADS1299_NUM_SCLK];
+	const struct spi_config *data_spi;
+#ifdef CONFIG_TI_ADS1299_DPPI_STREAM
+	const struct device *dev;
+	struct ads1299_stream stream;
+#endif
+};
+
+struct ti_ads1299_config {
+	struct spi_dt_spec spi;
+	/* Chips sharing CS and DRDY, 1 when not daisy-chained */
+	uint8_t num_devices;
+#ifdef ADS1299_NRFX_DRDY
+	/* Absolute (port-mapped) DRDY pin number for DPPI */
+	uint32_t drdy_pin;
+#endif
+#ifdef CONFIG_TI_ADS1299_DPPI_STREAM
+	/* Stream buffer sized for this instance's daisy chain */
+	uint8_t *stream_buf;
+	/* Raw SPIM peripheral the bus node maps to */
+	NRF_SPIM_Type *spim;
+	/* Absolute (port-mapped) CS pin number for the DPPI chain */
+	uint32_t cs_pin;
+#endif
+};
+
+#ifdef CONFIG_TI_ADS1299_TIMESTAMP
+#define ADS1299_TIMESTAMP_HZ TI_ADS1299_TIMESTAMP_HZ
+
+int ads1299_ts_init(void);
+/* Address of the task that latches the counter as the last DRDY time */
+uint32_t ads1299_ts_capture_task(void);
+int ads1299_ts_enable(const struct device *dev);
+uint32_t ads1299_ts_get(const struct device *dev);
+uint32_t ads1299_ts_now(const struct device *dev);
+#endif
+
+#ifdef CONFIG_TI_ADS1299_DPPI_STREAM
+int ads1299_stream_start(const struct device *dev, size_t frame_len,
+			 ti_ads1299_stream_cb_t cb, void *user_data);
+int ads1299_stream_stop(const struct device *dev);
+#endif
+
+#endif /* __TI_ADS1299_PRIV_H__ */
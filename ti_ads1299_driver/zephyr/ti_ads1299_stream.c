@@ -0,0 +1,571 @@
+/*
+ * Copyright (c) 2024 HHS
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*
+ * DRDY-triggered acquisition without a CPU wakeup per frame.
+ *
+ *   DRDY falling edge (GPIOTE IN) --DPPI--> EGU TRIGGER + DRDY TIMER COUNT
+ *   EGU TRIGGERED                 --DPPI--> CS low (GPIOTE CLR) + SPIM START
+ *   SPIM END                      --DPPI--> CS high (GPIOTE SET) + TIMER COUNT
+ *
+ * SPIM writes each frame into the next slot of an EasyDMA array list. The
+ * TIMER runs in counter mode and interrupts once per half of the list, so the
+ * CPU only sees one interrupt every CONFIG_TI_ADS1299_STREAM_FRAMES frames.
+ *
+ *   TIMER COMPARE1 (list full)    --DPPI--> CHG DIS (start channel off)
+ *   TIMER COMPARE0/1              --DPPI--> DRDY TIMER CAPTURE0/1
+ *
+ * Only the CPU can rewind the list, so the start channel sits in a channel
+ * group that the end of the list disables. A late interrupt then loses
+ * conversions instead of letting the DMA run past the buffer.
+ *
+ * A GPIOTE event publishes on a single DPPI channel, hence the EGU hop: the
+ * DRDY channel itself is never gated, and a second TIMER counts every edge.
+ * Its count is captured when a block completes, so the callback learns how
+ * many conversions were lost to the rewind or to a busy SPIM.
+ */
+
+#include "ti_ads1299_priv.h"
+
+#include <zephyr/kernel.h>
+#include <zephyr/irq.h>
+#include <zephyr/drivers/gpio.h>
+#include <zephyr/sys/printk.h>
+
+#include <hal/nrf_egu.h>
+#include <hal/nrf_gpio.h>
+#include <nrfx_gpiote.h>
+#include <nrfx_timer.h>
+#include <helpers/nrfx_gppi.h>
+
+/* TIMER instance counting SPIM END events, see NRFX_TIMER1 in Kconfig */
+#define STREAM_TIMER_IDX 1
+#define STREAM_IRQ_PRIO 1
+/* TIMER instance counting DRDY edges, see NRFX_TIMER0 in Kconfig */
+#define STREAM_DRDY_TIMER_IDX 0
+/* EGU instance and channel between the DRDY and the start channel */
+#define STREAM_EGU NRF_EGU0
+#define STREAM_EGU_CH 0
+
+/* Slack on top of the frame time when waiting for a transfer to drain */
+#define STREAM_DRAIN_MARGIN_US 20
+
+static const nrfx_timer_t stream_timer = NRFX_TIMER_INSTANCE(STREAM_TIMER_IDX);
+static const nrfx_timer_t drdy_timer =
+	NRFX_TIMER_INSTANCE(STREAM_DRDY_TIMER_IDX);
+
+static const nrfx_gpiote_t gpiote = NRFX_GPIOTE_INSTANCE(ADS1299_GPIOTE_IDX);
+
+#ifdef CONFIG_TI_ADS1299_TIMESTAMP
+/*
+ * Only the DRDY edge of the newest frame is captured. The frames before it
+ * are spaced back by the DRDY period measured since the previous block, or
+ * by the nominal period for the first block after start.
+ */
+static const uint32_t *stream_ts_fill(struct ads1299_data *data, size_t first,
+				      size_t count)
+{
+	struct ads1299_stream *stream = &data->stream;
+	uint32_t last = ads1299_ts_get(data->dev);
+	uint32_t *ts = &stream->ts[first];
+
+	if (stream->ts_period == 0) {
+		stream->ts_period =
+			ADS1299_TIMESTAMP_HZ / ads1299_sps(data->data_rate);
+	} else {
+		stream->ts_period = (last - stream->ts_last) / count;
+	}
+
+	for (size_t i = 0; i < count; i++) {
+		ts[i] = last - (count - 1 - i) * stream->ts_period;
+	}
+	stream->ts_last = last;
+
+	return ts;
+}
+#else
+static const uint32_t *stream_ts_fill(struct ads1299_data *data, size_t first,
+				      size_t count)
+{
+	return NULL;
+}
+#endif
+
+/* DRDY edges counted from the previous block up to the capture on @p cc */
+static uint32_t stream_drdy_take(struct ads1299_stream *stream,
+				 nrf_timer_cc_channel_t cc)
+{
+	uint32_t drdy = nrfx_timer_capture_get(&drdy_timer, cc);
+	uint32_t edges = drdy - stream->drdy_last;
+
+	stream->drdy_last = drdy;
+
+	return edges;
+}
+
+/*
+ * Reopen the start channel after the rewind. DRDY stays low until a frame is
+ * read, so a low pin means the interrupt came after the next edge: that
+ * conversion is read here as DPPI would have, older ones are lost.
+ */
+static void stream_resume(const struct ti_ads1299_config *cfg,
+			  struct ads1299_stream *stream)
+{
+	if (!nrf_gpio_pin_read(cfg->drdy_pin)) {
+		nrfx_gpiote_clr_task_trigger(&gpiote, cfg->cs_pin);
+		nrf_spim_task_trigger(cfg->spim, NRF_SPIM_TASK_START);
+	}
+	nrfx_gppi_group_enable(stream->group);
+}
+
+static void stream_timer_handler(nrf_timer_event_t event_type, void *p_context)
+{
+	struct ads1299_data *data = p_context;
+	struct ads1299_stream *stream = &data->stream;
+	const struct ti_ads1299_config *cfg = data->dev->config;
+	const size_t half = CONFIG_TI_ADS1299_STREAM_FRAMES;
+	const uint32_t *ts;
+	uint32_t drdy;
+
+	if (event_type == NRF_TIMER_EVENT_COMPARE0) {
+		ts = stream_ts_fill(data, 0, half);
+		drdy = stream_drdy_take(stream, NRF_TIMER_CC_CHANNEL0);
+		stream->cb(data->dev, stream->buf, ts, half, drdy,
+			   stream->user_data);
+	} else if (event_type == NRF_TIMER_EVENT_COMPARE1) {
+		/* DPPI stopped DRDY at the end of the list, rewind it */
+		nrf_spim_rx_buffer_set(cfg->spim, stream->buf,
+				       stream->frame_len);
+		stream_resume(cfg, stream);
+		ts = stream_ts_fill(data, half, half);
+		drdy = stream_drdy_take(stream, NRF_TIMER_CC_CHANNEL1);
+		stream->cb(data->dev, &stream->buf[half * stream->frame_len],
+			   ts, half, drdy, stream->user_data);
+	}
+}
+
+static int stream_gpiote_setup(const struct ti_ads1299_config *cfg,
+			       struct ads1299_stream *stream)
+{
+	nrfx_err_t nerr;
+
+	nerr = nrfx_gpiote_channel_alloc(&gpiote, &stream->drdy_ch);
+	if (nerr != NRFX_SUCCESS) {
+		return -ENOMEM;
+	}
+
+	nerr = nrfx_gpiote_channel_alloc(&gpiote, &stream->cs_ch);
+	if (nerr != NRFX_SUCCESS) {
+		nrfx_gpiote_channel_free(&gpiote, stream->drdy_ch);
+		return -ENOMEM;
+	}
+
+	/* DRDY only raises an event for DPPI, never an interrupt */
+	nrfx_gpiote_trigger_config_t trigger_config = {
+		.trigger = NRFX_GPIOTE_TRIGGER_HITOLO,
+		.p_in_channel = &stream->drdy_ch,
+	};
+	nrfx_gpiote_input_pin_config_t input_config = {
+		.p_trigger_config = &trigger_config,
+	};
+
+	nerr = nrfx_gpiote_input_configure(&gpiote, cfg->drdy_pin,
+					   &input_config);
+	if (nerr != NRFX_SUCCESS) {
+		goto err_free;
+	}
+	nrfx_gpiote_trigger_enable(&gpiote, cfg->drdy_pin, false);
+
+	/* CS is driven by SET/CLR tasks for the duration of the stream */
+	nrfx_gpiote_output_config_t output_config =
+		NRFX_GPIOTE_DEFAULT_OUTPUT_CONFIG;
+	nrfx_gpiote_task_config_t task_config = {
+		.task_ch = stream->cs_ch,
+		.polarity = NRF_GPIOTE_POLARITY_TOGGLE,
+		.init_val = NRF_GPIOTE_INITIAL_VALUE_HIGH,
+	};
+
+	nerr = nrfx_gpiote_output_configure(&gpiote, cfg->cs_pin,
+					    &output_config, &task_config);
+	if (nerr != NRFX_SUCCESS) {
+		nrfx_gpiote_pin_uninit(&gpiote, cfg->drdy_pin);
+		goto err_free;
+	}
+	nrfx_gpiote_out_task_enable(&gpiote, cfg->cs_pin);
+
+	return 0;
+
+err_free:
+	nrfx_gpiote_channel_free(&gpiote, stream->cs_ch);
+	nrfx_gpiote_channel_free(&gpiote, stream->drdy_ch);
+	return -EIO;
+}
+
+static void stream_gpiote_release(const struct ti_ads1299_config *cfg,
+				  struct ads1299_stream *stream)
+{
+	nrfx_gpiote_out_task_disable(&gpiote, cfg->cs_pin);
+	nrfx_gpiote_pin_uninit(&gpiote, cfg->cs_pin);
+	nrfx_gpiote_pin_uninit(&gpiote, cfg->drdy_pin);
+	nrfx_gpiote_channel_free(&gpiote, stream->cs_ch);
+	nrfx_gpiote_channel_free(&gpiote, stream->drdy_ch);
+
+	/* Hand CS back to the SPI driver in its idle state */
+	gpio_pin_configure_dt(&cfg->spi.config.cs.gpio, GPIO_OUTPUT_INACTIVE);
+}
+
+static int stream_timer_setup(struct ads1299_data *data)
+{
+	const uint32_t half = CONFIG_TI_ADS1299_STREAM_FRAMES;
+	nrfx_timer_config_t timer_config =
+		NRFX_TIMER_DEFAULT_CONFIG(NRFX_MHZ_TO_HZ(1));
+
+	timer_config.mode = NRF_TIMER_MODE_COUNTER;
+	timer_config.bit_width = NRF_TIMER_BIT_WIDTH_32;
+	timer_config.p_context = data;
+
+	if (nrfx_timer_init(&stream_timer, &timer_config,
+			    stream_timer_handler) != NRFX_SUCCESS) {
+		return -EBUSY;
+	}
+
+	IRQ_CONNECT(NRFX_IRQ_NUMBER_GET(NRF_TIMER_INST_GET(STREAM_TIMER_IDX)),
+		    STREAM_IRQ_PRIO,
+		    NRFX_TIMER_INST_HANDLER_GET(STREAM_TIMER_IDX), 0, 0);
+
+	nrfx_timer_compare(&stream_timer, NRF_TIMER_CC_CHANNEL0, half, true);
+	nrfx_timer_extended_compare(&stream_timer, NRF_TIMER_CC_CHANNEL1,
+				    2 * half,
+				    NRF_TIMER_SHORT_COMPARE1_CLEAR_MASK, true);
+
+	return 0;
+}
+
+/* DRDY edge counter, read back only through the captures */
+static int stream_drdy_timer_setup(void)
+{
+	nrfx_timer_config_t timer_config =
+		NRFX_TIMER_DEFAULT_CONFIG(NRFX_MHZ_TO_HZ(1));
+
+	timer_config.mode = NRF_TIMER_MODE_COUNTER;
+	timer_config.bit_width = NRF_TIMER_BIT_WIDTH_32;
+
+	if (nrfx_timer_init(&drdy_timer, &timer_config, NULL) !=
+	    NRFX_SUCCESS) {
+		return -EBUSY;
+	}
+
+	return 0;
+}
+
+static int stream_ppi_setup(const struct ti_ads1299_config *cfg,
+			    struct ads1299_stream *stream)
+{
+	if (nrfx_gppi_channel_alloc(&stream->ppi_drdy) != NRFX_SUCCESS) {
+		return -ENOMEM;
+	}
+	if (nrfx_gppi_channel_alloc(&stream->ppi_start) != NRFX_SUCCESS) {
+		goto err_free_drdy;
+	}
+	if (nrfx_gppi_channel_alloc(&stream->ppi_end) != NRFX_SUCCESS) {
+		goto err_free_start;
+	}
+	if (nrfx_gppi_channel_alloc(&stream->ppi_half) != NRFX_SUCCESS) {
+		goto err_free_end;
+	}
+	if (nrfx_gppi_channel_alloc(&stream->ppi_wrap) != NRFX_SUCCESS) {
+		goto err_free_half;
+	}
+	if (nrfx_gppi_group_alloc(&stream->group) != NRFX_SUCCESS) {
+		goto err_free_wrap;
+	}
+
+	nrfx_gppi_channel_endpoints_setup(
+		stream->ppi_drdy,
+		nrfx_gpiote_in_event_address_get(&gpiote, cfg->drdy_pin),
+		nrf_egu_task_address_get(
+			STREAM_EGU, nrf_egu_trigger_task_get(STREAM_EGU_CH)));
+	nrfx_gppi_fork_endpoint_setup(
+		stream->ppi_drdy,
+		nrfx_timer_task_address_get(&drdy_timer, NRF_TIMER_TASK_COUNT));
+
+	nrfx_gppi_channel_endpoints_setup(
+		stream->ppi_start,
+		nrf_egu_event_address_get(
+			STREAM_EGU, nrf_egu_triggered_event_get(STREAM_EGU_CH)),
+		nrfx_gpiote_clr_task_address_get(&gpiote, cfg->cs_pin));
+	nrfx_gppi_fork_endpoint_setup(
+		stream->ppi_start,
+		nrf_spim_task_address_get(cfg->spim, NRF_SPIM_TASK_START));
+#ifdef CONFIG_TI_ADS1299_TIMESTAMP
+	nrfx_gppi_fork_endpoint_setup(stream->ppi_start,
+				      ads1299_ts_capture_task());
+#endif
+
+	nrfx_gppi_channel_endpoints_setup(
+		stream->ppi_end,
+		nrf_spim_event_address_get(cfg->spim, NRF_SPIM_EVENT_END),
+		nrfx_gpiote_set_task_address_get(&gpiote, cfg->cs_pin));
+	nrfx_gppi_fork_endpoint_setup(
+		stream->ppi_end,
+		nrfx_timer_task_address_get(&stream_timer,
+					    NRF_TIMER_TASK_COUNT));
+
+	nrfx_gppi_channel_endpoints_setup(
+		stream->ppi_half,
+		nrfx_timer_compare_event_address_get(&stream_timer,
+						     NRF_TIMER_CC_CHANNEL0),
+		nrfx_timer_task_address_get(&drdy_timer,
+					    NRF_TIMER_TASK_CAPTURE0));
+
+	nrfx_gppi_channels_include_in_group(BIT(stream->ppi_start),
+					    stream->group);
+	nrfx_gppi_channel_endpoints_setup(
+		stream->ppi_wrap,
+		nrfx_timer_compare_event_address_get(&stream_timer,
+						     NRF_TIMER_CC_CHANNEL1),
+		nrfx_gppi_task_address_get(
+			nrfx_gppi_group_disable_task_get(stream->group)));
+	nrfx_gppi_fork_endpoint_setup(
+		stream->ppi_wrap,
+		nrfx_timer_task_address_get(&drdy_timer,
+					    NRF_TIMER_TASK_CAPTURE1));
+
+	return 0;
+
+err_free_wrap:
+	nrfx_gppi_channel_free(stream->ppi_wrap);
+err_free_half:
+	nrfx_gppi_channel_free(stream->ppi_half);
+err_free_end:
+	nrfx_gppi_channel_free(stream->ppi_end);
+err_free_start:
+	nrfx_gppi_channel_free(stream->ppi_start);
+err_free_drdy:
+	nrfx_gppi_channel_free(stream->ppi_drdy);
+	return -ENOMEM;
+}
+
+static void stream_ppi_release(const struct ti_ads1299_config *cfg,
+			       struct ads1299_stream *stream)
+{
+	nrfx_gppi_group_disable(stream->group);
+	nrfx_gppi_channels_disable(BIT(stream->ppi_drdy) |
+				   BIT(stream->ppi_start) |
+				   BIT(stream->ppi_end) |
+				   BIT(stream->ppi_half) |
+				   BIT(stream->ppi_wrap));
+	nrfx_gppi_group_clear(stream->group);
+	nrfx_gppi_group_free(stream->group);
+
+	nrfx_gppi_channel_endpoints_clear(
+		stream->ppi_drdy,
+		nrfx_gpiote_in_event_address_get(&gpiote, cfg->drdy_pin),
+		nrf_egu_task_address_get(
+			STREAM_EGU, nrf_egu_trigger_task_get(STREAM_EGU_CH)));
+	nrfx_gppi_fork_endpoint_clear(
+		stream->ppi_drdy,
+		nrfx_timer_task_address_get(&drdy_timer, NRF_TIMER_TASK_COUNT));
+	nrfx_gppi_channel_endpoints_clear(
+		stream->ppi_start,
+		nrf_egu_event_address_get(
+			STREAM_EGU, nrf_egu_triggered_event_get(STREAM_EGU_CH)),
+		nrfx_gpiote_clr_task_address_get(&gpiote, cfg->cs_pin));
+	nrfx_gppi_fork_endpoint_clear(
+		stream->ppi_start,
+		nrf_spim_task_address_get(cfg->spim, NRF_SPIM_TASK_START));
+#ifdef CONFIG_TI_ADS1299_TIMESTAMP
+	nrfx_gppi_fork_endpoint_clear(stream->ppi_start,
+				      ads1299_ts_capture_task());
+#endif
+	nrfx_gppi_channel_endpoints_clear(
+		stream->ppi_end,
+		nrf_spim_event_address_get(cfg->spim, NRF_SPIM_EVENT_END),
+		nrfx_gpiote_set_task_address_get(&gpiote, cfg->cs_pin));
+	nrfx_gppi_fork_endpoint_clear(
+		stream->ppi_end,
+		nrfx_timer_task_address_get(&stream_timer,
+					    NRF_TIMER_TASK_COUNT));
+	nrfx_gppi_channel_endpoints_clear(
+		stream->ppi_half,
+		nrfx_timer_compare_event_address_get(&stream_timer,
+						     NRF_TIMER_CC_CHANNEL0),
+		nrfx_timer_task_address_get(&drdy_timer,
+					    NRF_TIMER_TASK_CAPTURE0));
+	nrfx_gppi_channel_endpoints_clear(
+		stream->ppi_wrap,
+		nrfx_timer_compare_event_address_get(&stream_timer,
+						     NRF_TIMER_CC_CHANNEL1),
+		nrfx_gppi_task_address_get(
+			nrfx_gppi_group_disable_task_get(stream->group)));
+	nrfx_gppi_fork_endpoint_clear(
+		stream->ppi_wrap,
+		nrfx_timer_task_address_get(&drdy_timer,
+					    NRF_TIMER_TASK_CAPTURE1));
+
+	nrfx_gppi_channel_free(stream->ppi_drdy);
+	nrfx_gppi_channel_free(stream->ppi_start);
+	nrfx_gppi_channel_free(stream->ppi_end);
+	nrfx_gppi_channel_free(stream->ppi_half);
+	nrfx_gppi_channel_free(stream->ppi_wrap);
+}
+
+/* Point SPIM at the DMA list. The Zephyr SPI driver must not see END. */
+static void stream_spim_setup(const struct ti_ads1299_config *cfg,
+			      struct ads1299_stream *stream)
+{
+	NRF_SPIM_Type *spim = cfg->spim;
+
+	stream->orc = spim->ORC;
+
+	nrf_spim_int_disable(spim, NRF_SPIM_INT_END_MASK);
+	nrf_spim_event_clear(spim, NRF_SPIM_EVENT_END);
+	/* DIN must stay free of opcodes while in RDATAC */
+	nrf_spim_orc_set(spim, 0x00);
+	nrf_spim_tx_buffer_set(spim, NULL, 0);
+	nrf_spim_rx_buffer_set(spim, stream->buf, stream->frame_len);
+	nrf_spim_rx_list_enable(spim);
+}
+
+static void stream_spim_release(const struct ti_ads1299_config *cfg,
+				struct ads1299_stream *stream)
+{
+	NRF_SPIM_Type *spim = cfg->spim;
+
+	nrf_spim_rx_list_disable(spim);
+	nrf_spim_orc_set(spim, stream->orc);
+	nrf_spim_event_clear(spim, NRF_SPIM_EVENT_END);
+	nrf_spim_int_enable(spim, NRF_SPIM_INT_END_MASK);
+}
+
+int ads1299_stream_start(const struct device *dev, size_t frame_len,
+			 ti_ads1299_stream_cb_t cb, void *user_data)
+{
+	const struct ti_ads1299_config *cfg = dev->config;
+	struct ads1299_data *data = dev->data;
+	struct ads1299_stream *stream = &data->stream;
+	int err;
+
+	if (stream->running) {
+		return -EALREADY;
+	}
+	if (cb == NULL || frame_len == 0 ||
+	    frame_len > ADS1299_FRAME_LEN(cfg->num_devices)) {
+		return -EINVAL;
+	}
+
+	stream->buf = cfg->stream_buf;
+	stream->frame_len = frame_len;
+#ifdef CONFIG_TI_ADS1299_TIMESTAMP
+	stream->ts_period = 0;
+#endif
+	stream->drdy_last = 0;
+	stream->cb = cb;
+	stream->user_data = user_data;
+
+	/*
+	 * Take the bus lock for the whole stream. The read also leaves SPIM
+	 * configured with this device's frequency and mode.
+	 */
+	stream->lock_cfg = *data->data_spi;
+	stream->lock_cfg.operation |= SPI_LOCK_ON;
+
+	struct spi_buf rx_buf = { .buf = stream->buf, .len = frame_len };
+	struct spi_buf_set rx = { .buffers = &rx_buf, .count = 1 };
+
+	err = spi_read(cfg->spi.bus, &stream->lock_cfg, &rx);
+	if (err != 0) {
+		printk("Failed to lock SPI bus for streaming, err: %d\n", err);
+		return err;
+	}
+
+	err = stream_gpiote_setup(cfg, stream);
+	if (err != 0) {
+		goto err_release_bus;
+	}
+
+	err = stream_timer_setup(data);
+	if (err != 0) {
+		goto err_release_gpiote;
+	}
+
+	err = stream_drdy_timer_setup();
+	if (err != 0) {
+		goto err_release_timer;
+	}
+
+	err = stream_ppi_setup(cfg, stream);
+	if (err != 0) {
+		goto err_release_drdy_timer;
+	}
+
+	stream_spim_setup(cfg, stream);
+
+	nrfx_timer_enable(&stream_timer);
+	nrfx_timer_enable(&drdy_timer);
+	nrfx_gppi_channels_enable(BIT(stream->ppi_drdy) | BIT(stream->ppi_end) |
+				  BIT(stream->ppi_half) |
+				  BIT(stream->ppi_wrap));
+	nrfx_gppi_group_enable(stream->group);
+	stream->running = true;
+
+	return 0;
+
+err_release_drdy_timer:
+	nrfx_timer_uninit(&drdy_timer);
+err_release_timer:
+	nrfx_timer_uninit(&stream_timer);
+err_release_gpiote:
+	stream_gpiote_release(cfg, stream);
+err_release_bus:
+	spi_release(cfg->spi.bus, &stream->lock_cfg);
+	printk("Failed to start ADS1299 stream, err: %d\n", err);
+	return err;
+}
+
+int ads1299_stream_stop(const struct device *dev)
+{
+	const struct ti_ads1299_config *cfg = dev->config;
+	struct ads1299_data *data = dev->data;
+	struct ads1299_stream *stream = &data->stream;
+
+	if (!stream->running) {
+		return -EALREADY;
+	}
+
+	stream_ppi_release(cfg, stream);
+
+	/* Let a frame already in flight finish before touching SPIM */
+	k_busy_wait(DIV_ROUND_UP(stream->frame_len * 8 * USEC_PER_SEC,
+				 stream->lock_cfg.frequency) +
+		    STREAM_DRAIN_MARGIN_US);
+
+	/* Hand over the frames of the block that was still filling */
+	uint32_t count = nrfx_timer_capture(&stream_timer,
+					    NRF_TIMER_CC_CHANNEL2);
+	uint32_t filled = count % CONFIG_TI_ADS1299_STREAM_FRAMES;
+
+	if (filled != 0) {
+		size_t first = count - filled;
+
+		nrfx_timer_capture(&drdy_timer, NRF_TIMER_CC_CHANNEL2);
+		stream->cb(dev, &stream->buf[first * stream->frame_len],
+			   stream_ts_fill(data, first, filled), filled,
+			   stream_drdy_take(stream, NRF_TIMER_CC_CHANNEL2),
+			   stream->user_data);
+	}
+
+	nrfx_timer_disable(&drdy_timer);
+	nrfx_timer_uninit(&drdy_timer);
+	nrfx_timer_disable(&stream_timer);
+	nrfx_timer_uninit(&stream_timer);
+	stream_spim_release(cfg, stream);
+	stream_gpiote_release(cfg, stream);
+
+	stream->running = false;
+
+	return spi_release(cfg->spi.bus, &stream->lock_cfg);
+}
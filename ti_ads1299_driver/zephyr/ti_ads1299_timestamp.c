@@ -0,0 +1,109 @@
+/*
+ * Copyright (c) 2024 HHS
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*
+ * Hardware timestamps for DRDY edges.
+ *
+ *   DRDY falling edge (GPIOTE IN) --DPPI--> TIMER2 CAPTURE0
+ *
+ * TIMER2 free-runs at 16 MHz, so CC0 always holds the time of the last
+ * conversion, whatever the interrupt or thread latency of the reader. CC1 is
+ * used to sample the current time on request. The 32-bit counter wraps after
+ * ~268 s; consumers work with differences.
+ */
+
+#include "ti_ads1299_priv.h"
+
+#include <zephyr/kernel.h>
+#include <zephyr/sys/printk.h>
+
+#include <nrfx_gpiote.h>
+#include <nrfx_timer.h>
+#include <helpers/nrfx_gppi.h>
+
+/* TIMER instance used as time base, see NRFX_TIMER2 in Kconfig */
+#define TS_TIMER_IDX 2
+
+static const nrfx_timer_t ts_timer = NRFX_TIMER_INSTANCE(TS_TIMER_IDX);
+static const nrfx_gpiote_t gpiote = NRFX_GPIOTE_INSTANCE(ADS1299_GPIOTE_IDX);
+
+/* DPPI channel of the polled-mode DRDY -> CAPTURE0 link */
+static uint8_t ts_ppi;
+static bool ts_linked;
+
+int ads1299_ts_init(void)
+{
+	nrfx_timer_config_t timer_config =
+		NRFX_TIMER_DEFAULT_CONFIG(ADS1299_TIMESTAMP_HZ);
+
+	timer_config.bit_width = NRF_TIMER_BIT_WIDTH_32;
+
+	/* Shared by all instances, the first one starts it */
+	if (nrfx_timer_init_check(&ts_timer)) {
+		return 0;
+	}
+
+	/* No compare events are used, so no handler and no IRQ */
+	if (nrfx_timer_init(&ts_timer, &timer_config, NULL) != NRFX_SUCCESS) {
+		return -EBUSY;
+	}
+	nrfx_timer_enable(&ts_timer);
+
+	return 0;
+}
+
+uint32_t ads1299_ts_capture_task(void)
+{
+	return nrfx_timer_task_address_get(&ts_timer, NRF_TIMER_TASK_CAPTURE0);
+}
+
+/*
+ * Link the DRDY edge to the capture task for polled acquisition. The pin
+ * must already be configured for edge interrupts so a GPIOTE IN channel
+ * exists; the DPPI stream forks the capture from its own start channel and
+ * does not need this.
+ */
+int ads1299_ts_enable(const struct device *dev)
+{
+	const struct ti_ads1299_config *cfg = dev->config;
+	uint8_t ch;
+
+	if (ts_linked) {
+		return -EALREADY;
+	}
+
+	if (nrfx_gpiote_channel_get(&gpiote, cfg->drdy_pin, &ch) !=
+	    NRFX_SUCCESS) {
+		printk("DRDY pin has no GPIOTE channel, configure it first\n");
+		return -EINVAL;
+	}
+
+	if (nrfx_gppi_channel_alloc(&ts_ppi) != NRFX_SUCCESS) {
+		return -ENOMEM;
+	}
+
+	nrfx_gppi_channel_endpoints_setup(
+		ts_ppi, nrfx_gpiote_in_event_address_get(&gpiote, cfg->drdy_pin),
+		ads1299_ts_capture_task());
+	nrfx_gppi_channels_enable(BIT(ts_ppi));
+	ts_linked = true;
+
+	return 0;
+}
+
+uint32_t ads1299_ts_get(const struct device *dev)
+{
+	ARG_UNUSED(dev);
+
+	return nrfx_timer_capture_get(&ts_timer, NRF_TIMER_CC_CHANNEL0);
+}
+
+uint32_t ads1299_ts_now(const struct device *dev)
+{
+	ARG_UNUSED(dev);
+
+	return nrfx_timer_capture(&ts_timer, NRF_TIMER_CC_CHANNEL1);
+}